@@ -0,0 +1,106 @@
+/**
+ * \file bench_bind.cpp
+ * Reading of the array of records into structs: loading of the tree
+ * followed by the copy of its values against the typed binding.
+ */
+
+#include <json_bind.h>
+#include <litejson.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+struct service
+{
+  std::string host;
+  int port = 0;
+  double weight = 0;
+  std::vector<std::string> tags;
+};
+
+template<>
+struct litejson::json_fields<service>
+{
+  static constexpr auto list = std::make_tuple(litejson::field("host", &service::host),
+                                               litejson::field("port", &service::port),
+                                               litejson::field("weight", &service::weight),
+                                               litejson::field("tags", &service::tags));
+};
+
+static std::string make_text(size_t size)
+{
+  std::string text = "[";
+
+  for (int i = 0; text.size() < size; i++)
+    text += std::string(i != 0 ? ",\n" : "\n") + "  {\"host\": \"node-" + std::to_string(i % 97) +
+            ".example.internal\", \"port\": " + std::to_string(8000 + i % 1000) + ", \"weight\": " +
+            std::to_string(i % 10 * 0.1) + ", \"tags\": [\"blue\", \"green\", \"canary\"]}";
+  text += "\n]\n";
+  return text;
+}
+
+template<class F>
+static void run(const char* name, size_t size, int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for (int r = 0; r < rounds; r++)
+    if (!f())
+      {
+        std::cout << name << "\tfailed" << std::endl;
+        std::exit(1);
+      }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << size * rounds / seconds / 1e6 << " MB/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16 * 1024 * 1024;
+  std::string text = make_text(size);
+
+  run("tree and copy", text.size(), 5, [&]()
+    {
+      litejson::json_loader loader;
+      std::vector<service> services;
+      litejson::json_value* item;
+      litejson::json_value* tag;
+
+      if (!loader.load(text))
+        return false;
+
+      for (int i = 0; (item = loader.root()->as_array(i)) != nullptr; i++)
+        {
+          service& s = services.emplace_back();
+
+          s.host = item->as_object("host")->as_string();
+          s.port = item->as_object("port")->as_integer();
+          s.weight = item->as_object("weight")->as_double();
+          for (int j = 0; (tag = item->as_object("tags")->as_array(j)) != nullptr; j++)
+            s.tags.push_back(tag->as_string());
+        }
+      return services.size() > 1234 && services[1234].port == 8234;
+    });
+
+  run("from_json", text.size(), 5, [&]()
+    {
+      std::vector<service> services;
+
+      return litejson::from_json(text, services) && services.size() > 1234 && services[1234].port == 8234;
+    });
+
+  run("to_json", text.size(), 5, [&]()
+    {
+      static std::vector<service> services;
+
+      if (services.empty() && !litejson::from_json(text, services))
+        return false;
+      return litejson::to_json(services).size() > size / 2;
+    });
+
+  return 0;
+}
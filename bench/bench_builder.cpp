@@ -0,0 +1,134 @@
+/**
+ * \file bench_builder.cpp
+ * Building of a large response document and its output: entries made
+ * by new and added by pointer against entries moved or constructed in
+ * place into reserved storage. Allocations are counted by operator new.
+ */
+
+#include <litejson.h>
+#include <json_writer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+static size_t alloc_count;
+
+void* operator new(size_t size)
+{
+  void* p;
+
+  alloc_count++;
+  if ((p = std::malloc(size != 0 ? size : 1)) == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+static const char* const tags[] = { "blue", "green", "canary" };
+
+/**
+ * Records by the pointer calls
+ */
+static void build_old(litejson::json_value& root, int records)
+{
+  litejson::json_value* items = new litejson::json_value();
+
+  for (int i = 0; i < records; i++)
+    {
+      litejson::json_value* item = new litejson::json_value();
+      litejson::json_value* list = new litejson::json_value();
+
+      item->add_object_entry("id", new litejson::json_value(i));
+      item->add_object_entry("host", new litejson::json_value("node-" + std::to_string(i % 97) + ".example.internal"));
+      item->add_object_entry("weight", new litejson::json_value(i % 10 * 0.1));
+      item->add_object_entry("enabled", new litejson::json_value(i % 3 != 0));
+      for (const char* tag : tags)
+        list->add_array_entry(new litejson::json_value(tag));
+      item->add_object_entry("tags", list);
+      items->add_array_entry(item);
+    }
+  root.add_object_entry("items", items);
+  root.add_object_entry("count", new litejson::json_value(records));
+}
+
+/**
+ * Same records by the move and emplace calls
+ */
+static void build_new(litejson::json_value& root, int records)
+{
+  root.make_object();
+  root.reserve(2);                                      // References of the entries stay valid
+
+  litejson::json_value& items = root.emplace_object_entry("items");
+
+  items.make_array();
+  items.reserve(records);
+  for (int i = 0; i < records; i++)
+    {
+      litejson::json_value& item = items.emplace_array_entry();
+
+      item.make_object();
+      item.reserve(5);
+      item.emplace_object_entry("id", i);
+      item.emplace_object_entry("host", "node-" + std::to_string(i % 97) + ".example.internal");
+      item.emplace_object_entry("weight", i % 10 * 0.1);
+      item.emplace_object_entry("enabled", i % 3 != 0);
+
+      litejson::json_value& list = item.emplace_object_entry("tags");
+
+      list.make_array();
+      list.reserve(3);
+      for (const char* tag : tags)
+        list.emplace_array_entry(tag);
+    }
+  root.emplace_object_entry("count", records);
+}
+
+template<class F>
+static void run(const char* name, int records, int rounds, F f)
+{
+  size_t bytes = 0;
+  size_t allocs = 0;
+  double build = 0;
+  double write = 0;
+
+  for (int r = 0; r < rounds; r++)
+    {
+      litejson::json_value root;
+      size_t before = alloc_count;
+      auto start = std::chrono::steady_clock::now();
+
+      f(root, records);
+      allocs += alloc_count - before;
+
+      auto built = std::chrono::steady_clock::now();
+
+      bytes = litejson::json_writer::to_string(root).size();
+      build += std::chrono::duration<double>(built - start).count();
+      write += std::chrono::duration<double>(std::chrono::steady_clock::now() - built).count();
+    }
+
+  std::cout << name << "\tbuild " << build / rounds * 1e3 << " ms\twrite " << write / rounds * 1e3 << " ms\t"
+            << allocs / rounds << " allocations\t(" << bytes << " bytes)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  int records = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+  run("pointer calls", records, 5, build_old);
+  run("emplace calls", records, 5, build_new);
+  return 0;
+}
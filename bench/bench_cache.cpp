@@ -0,0 +1,83 @@
+/**
+ * \file bench_cache.cpp
+ * Startup time: parsing of the JSON text file against opening of its
+ * binary cache, both followed by a few lookups.
+ */
+
+#include <json_cache.h>
+#include <litejson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static void make_config(const std::string& name, size_t size)
+{
+  std::ofstream file(name, std::ios::binary | std::ios::trunc);
+  size_t written = 1;
+
+  file << "{";
+  for (int i = 0; written < size; i++)
+    {
+      std::string entry = std::string(i != 0 ? ",\n" : "\n") + "  \"service" + std::to_string(i) + "\": {\"host\": \"node-" +
+                          std::to_string(i % 97) + ".example.internal\", \"port\": " + std::to_string(8000 + i % 1000) +
+                          ", \"weight\": " + std::to_string(i % 10 * 0.1) + ", \"tags\": [\"blue\", \"green\", \"canary\"]}";
+
+      file << entry;
+      written += entry.size();
+    }
+  file << "\n}\n";
+}
+
+template<class F>
+static void run(const char* name, int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for (int r = 0; r < rounds; r++)
+    if (!f())
+      {
+        std::cout << name << "\tfailed" << std::endl;
+        std::exit(1);
+      }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << seconds / rounds * 1e3 << " ms" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64 * 1024 * 1024;
+  std::string source = "bench_cache.json";
+  std::string cache_name = "bench_cache.bin";
+
+  make_config(source, size);
+
+  run("parse text", 3, [&]()
+    {
+      litejson::json_loader loader(source);
+
+      return loader.root() != nullptr && loader.root()->as_object("service1234")->as_object("port")->as_integer() == 8234;
+    });
+
+  run("build cache", 1, [&]()
+    {
+      return litejson::json_cache::build(source, cache_name);
+    });
+
+  run("open cache", 10, [&]()
+    {
+      litejson::json_cache cache;
+
+      return cache.open_or_build(source, cache_name) &&
+             cache.root()->as_object("service1234")->as_object("port")->as_integer() == 8234;
+    });
+
+  std::remove(source.c_str());
+  std::remove(cache_name.c_str());
+  return 0;
+}
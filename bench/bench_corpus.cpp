@@ -0,0 +1,485 @@
+/**
+ * \file bench_corpus.cpp
+ * Benchmark driver over a generated corpus. Every shape is made by
+ * the fixed seed generator, so the same sizes give the same bytes on
+ * every run. For every shape, size and phase the driver prints MB/s,
+ * documents/s, peak RSS of the phase and allocations per round as
+ * tab separated lines (or JSON lines with --json) to diff between
+ * commits. The two_pass row times the whole two pass load; its lexical()
+ * and syntax() parts are reported as the lexical and syntax rows, timed
+ * by the loader statistics (json_stats::ph_lexical and ph_syntax) of
+ * the same loads, and share RSS and allocations of the load. The rest
+ * of the two_pass time is spent outside of the passes, e.g. to release
+ * the previous tree.
+ * The sax phase only parses the events, before any tree is made.
+ * The zero_copy phase is the single pass load with strings which refer
+ * to the text.
+ *
+ * Usage: bench_corpus [--sizes 1K,64K,1M,16M] [--shapes deep,wide,...]
+ *                     [--time seconds] [--json] [--write dir]
+ *
+ * make check runs it on the 1K size only, one round per phase, as a
+ * smoke test; larger sizes are left to make bench-corpus.
+ */
+
+#include <litejson.h>
+#include <json_sax.h>
+#include <json_stream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+
+/*
+ * Allocation counters. glibc exports the real allocator as __libc_*,
+ * so malloc() of the arena and operator new are both counted here.
+ */
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+static size_t alloc_count;
+static size_t alloc_bytes;
+
+extern "C" void* malloc(size_t size)
+{
+  alloc_count++;
+  alloc_bytes += size;
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+  alloc_count++;
+  alloc_bytes += count * size;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+  alloc_count++;
+  alloc_bytes += size;
+  return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr)
+{
+  __libc_free(ptr);
+}
+
+#else
+
+static size_t alloc_count;                              // Not counted
+static size_t alloc_bytes;
+
+#endif
+
+/**
+ * Generator of the pseudo random numbers. Unlike std:: distributions
+ * it gives the same sequence with every standard library.
+ */
+class generator
+{
+
+  uint64_t m_state;
+
+public:
+
+  generator() : m_state(0x9E3779B97F4A7C15ull) {}
+
+  uint64_t next()
+  {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 7;
+    m_state ^= m_state << 17;
+    return m_state;
+  }
+
+  unsigned below(unsigned n) { return unsigned(next() % n); }
+
+};
+
+/**
+ * Output buffer which drops all the characters
+ */
+class null_buffer : public std::streambuf
+{
+
+protected:
+
+  int overflow(int c) override { return c == EOF ? 0 : c; }
+  std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+
+};
+
+/**
+ * Shape of the corpus documents
+ */
+struct shape
+{
+  const char* name;
+  void (*make)(std::string& text, size_t size);
+  bool lines;                                           // JSON Lines, one document per line
+};
+
+static void make_deep(std::string& text, size_t size)
+{
+  generator gen;
+
+  text = "[";
+  while (text.size() < size)
+    {
+      unsigned depth = 32 + gen.below(96);
+
+      for (unsigned i = 0; i < depth; i++)
+        text += i % 2 == 0 ? "{\"child\":" : "[";
+      text += std::to_string(gen.below(1000));
+      for (unsigned i = depth; i != 0; i--)
+        text += (i - 1) % 2 == 0 ? "}" : "]";
+      text += ",";
+    }
+  text.back() = ']';
+}
+
+static void make_wide(std::string& text, size_t size)
+{
+  generator gen;
+
+  text = "{";
+  for (unsigned i = 0; text.size() < size; i++)
+    text += "\"key" + std::to_string(i) + "_" + std::to_string(gen.below(100000)) + "\":" +
+            std::to_string(gen.below(1000000)) + ",";
+  text.back() = '}';
+}
+
+static void make_numbers(std::string& text, size_t size)
+{
+  generator gen;
+
+  text = "[";
+  for (unsigned i = 0; text.size() < size; i++)
+    {
+      uint64_t n = gen.next();
+
+      switch (i % 3)
+        {
+        case 0:
+          text += std::to_string(int64_t(n) >> 20);
+          break;
+        case 1:
+          text += std::to_string(n % 100000) + "." + std::to_string(n % 1000);
+          break;
+        default:
+          text += std::to_string(n % 1000) + "." + std::to_string(n % 997) + "e-" + std::to_string(n % 30);
+          break;
+        }
+      text += ",";
+    }
+  text.back() = ']';
+}
+
+static void make_strings(std::string& text, size_t size)
+{
+  static const char* words[] = { "alpha", "beta", "gamma", "delta", "\\\"quoted\\\"", "tab\\t", "line\\n",
+                                 "\\u00e9t\\u00e9", "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82", "path\\/to" };
+  generator gen;
+
+  text = "[";
+  while (text.size() < size)
+    {
+      unsigned count = 1 + gen.below(40);
+
+      text += "\"";
+      for (unsigned i = 0; i < count; i++)
+        text += std::string(words[gen.below(10)]) + " ";
+      text += "\",";
+    }
+  text.back() = ']';
+}
+
+static void make_pretty(std::string& text, size_t size)
+{
+  std::string indent(16, ' ');
+  generator gen;
+
+  text = "[\n";
+  for (unsigned i = 0; text.size() < size; i++)
+    {
+      text += indent + "{\n";
+      text += indent + indent + "\"id\"      :      " + std::to_string(i) + ",\n";
+      text += indent + indent + "\"score\"   :      " + std::to_string(gen.below(10000)) + ",\n";
+      text += indent + indent + "\"tags\"    :      [ \"a\" ,   \"b\" ,   \"c\" ]\n";
+      text += indent + "},\n";
+    }
+  text.resize(text.size() - 2);
+  text += "\n]\n";
+}
+
+static void make_lines(std::string& text, size_t size)
+{
+  generator gen;
+
+  text.clear();
+  for (unsigned i = 0; text.size() < size; i++)
+    text += "{\"ts\":" + std::to_string(1700000000 + i) + ",\"user\":" + std::to_string(gen.below(977)) +
+            ",\"msg\":\"served in " + std::to_string(gen.below(300)) + " ms\",\"ok\":true}\n";
+}
+
+static const shape shapes[] =
+  {
+    { "deep", make_deep, false },
+    { "wide", make_wide, false },
+    { "numbers", make_numbers, false },
+    { "strings", make_strings, false },
+    { "pretty", make_pretty, false },
+    { "ndjson", make_lines, true }
+  };
+
+/**
+ * Peak RSS since the last reset in KB, 0 if unknown
+ */
+static size_t peak_rss()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+
+  while (std::getline(status, line))
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::strtoul(line.c_str() + 6, nullptr, 10);
+  return 0;
+}
+
+static void reset_peak_rss()
+{
+  std::ofstream clear("/proc/self/clear_refs");
+
+  clear << "5";
+}
+
+/**
+ * Result of one phase
+ */
+struct result
+{
+  double seconds;
+  size_t rounds;
+  size_t documents;                                     // Per round
+  size_t rss;
+  size_t allocations;                                   // Per round
+  size_t allocated;                                     // Per round
+};
+
+/**
+ * Run the phase until the time is over, at least once
+ *
+ * \param [in] time  -- Minimal time of the phase, s
+ * \param [in] phase -- Phase, returns number of the documents or 0 on error
+ * \return Result of the phase
+ */
+static result measure(double time, const std::function<size_t()>& phase)
+{
+  result res = {};
+  size_t count = alloc_count;
+  size_t bytes = alloc_bytes;
+  auto start = std::chrono::steady_clock::now();
+
+  reset_peak_rss();
+  do
+    {
+      res.documents = phase();
+      if (res.documents == 0)
+        {
+          std::cerr << "phase failed" << std::endl;
+          std::exit(1);
+        }
+      res.rounds++;
+      res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+  while (res.seconds < time);
+
+  res.rss = peak_rss();
+  res.allocations = (alloc_count - count) / res.rounds;
+  res.allocated = (alloc_bytes - bytes) / res.rounds;
+  return res;
+}
+
+static void report(bool json, const char* shape, size_t size, const char* phase, const result& res)
+{
+  double mb = double(size) * res.rounds / res.seconds / 1e6;
+  double docs = double(res.documents) * res.rounds / res.seconds;
+
+  if (json)
+    std::cout << "{\"shape\":\"" << shape << "\",\"size\":" << size << ",\"phase\":\"" << phase
+              << "\",\"mb_s\":" << mb << ",\"docs_s\":" << docs << ",\"peak_rss_kb\":" << res.rss
+              << ",\"allocs\":" << res.allocations << ",\"alloc_bytes\":" << res.allocated << "}" << std::endl;
+  else
+    std::cout << shape << "\t" << size << "\t" << phase << "\t" << mb << "\t" << docs << "\t" << res.rss
+              << "\t" << res.allocations << "\t" << res.allocated << std::endl;
+}
+
+/**
+ * Parse size with K, M or G suffix
+ */
+static size_t parse_size(const std::string& str)
+{
+  char* end;
+  size_t size = std::strtoul(str.c_str(), &end, 10);
+
+  switch (*end)
+    {
+    case 'G': size *= 1024;                             // Fall through
+    case 'M': size *= 1024;                             // Fall through
+    case 'K': size *= 1024; break;
+    default: break;
+    }
+  return size;
+}
+
+static std::vector<std::string> split(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::istringstream stream(list);
+  std::string item;
+
+  while (std::getline(stream, item, ','))
+    items.push_back(item);
+  return items;
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> sizes = { "1K", "64K", "1M", "16M" };
+  std::vector<std::string> names;
+  std::string directory;
+  double time = 0.2;
+  bool json = false;
+  null_buffer null;
+  std::ostream drop(&null);
+  std::string text;
+
+  for (int i = 1; i < argc; i++)
+    {
+      std::string arg = argv[i];
+
+      if (arg == "--json")
+        json = true;
+      else if (arg == "--sizes" && i + 1 < argc)
+        sizes = split(argv[++i]);
+      else if (arg == "--shapes" && i + 1 < argc)
+        names = split(argv[++i]);
+      else if (arg == "--time" && i + 1 < argc)
+        time = std::strtod(argv[++i], nullptr);
+      else if (arg == "--write" && i + 1 < argc)
+        directory = argv[++i];
+      else
+        {
+          std::cerr << "Usage: " << argv[0] << " [--sizes 1K,64K,1M,16M] [--shapes deep,wide,numbers,strings,pretty,ndjson]"
+                    " [--time seconds] [--json] [--write dir]" << std::endl;
+          return 1;
+        }
+    }
+
+  if (!json)
+    std::cout << "shape\tsize\tphase\tmb_s\tdocs_s\tpeak_rss_kb\tallocs\talloc_bytes" << std::endl;
+
+  for (const shape& sh : shapes)
+    {
+      if (!names.empty() && std::find(names.begin(), names.end(), sh.name) == names.end())
+        continue;
+
+      for (const std::string& size_name : sizes)
+        {
+          sh.make(text, parse_size(size_name));
+
+          if (!directory.empty())
+            {
+              std::ofstream file(directory + "/" + sh.name + "-" + size_name + (sh.lines ? ".jsonl" : ".json"));
+
+              file << text;
+            }
+
+          if (sh.lines)
+            {
+              litejson::json_stream stream;
+
+              report(json, sh.name, text.size(), "stream", measure(time, [&]()
+                {
+                  size_t documents = 0;
+
+                  stream.open(text);
+                  while (stream.next() != nullptr)
+                    documents++;
+                  return stream.bad() ? 0 : documents;
+                }));
+              continue;
+            }
+
+          litejson::json_sax_handler handler;
+          litejson::json_sax_parser<litejson::json_sax_handler> parser(handler);
+
+          report(json, sh.name, text.size(), "sax", measure(time, [&]()
+            {
+              return parser.parse(text) ? 1 : 0;
+            }));
+
+          litejson::json_loader loader;
+
+          report(json, sh.name, text.size(), "single_pass", measure(time, [&]()
+            {
+              return loader.load(text) ? 1 : 0;
+            }));
+
+          loader.set_zero_copy(true);
+          report(json, sh.name, text.size(), "zero_copy", measure(time, [&]()
+            {
+              return loader.load(text) ? 1 : 0;
+            }));
+          loader.set_zero_copy(false);
+
+          report(json, sh.name, text.size(), "two_pass", measure(time, [&]()
+            {
+              return loader.load(text, litejson::json_loader::pm_two_pass) ? 1 : 0;
+            }));
+
+          double phases[litejson::json_stats::ph_count] = {};
+          result split;
+
+          loader.enable_stats(true);
+          split = measure(time, [&]()
+            {
+              if (!loader.load(text, litejson::json_loader::pm_two_pass))
+                return 0;
+              for (int i = 0; i < litejson::json_stats::ph_count; i++)
+                phases[i] += loader.stats()->time[i];
+              return 1;
+            });
+          loader.enable_stats(false);
+
+          split.seconds = phases[litejson::json_stats::ph_lexical];
+          report(json, sh.name, text.size(), "lexical", split);
+          split.seconds = phases[litejson::json_stats::ph_syntax];
+          report(json, sh.name, text.size(), "syntax", split);
+
+          report(json, sh.name, text.size(), "print", measure(time, [&]()
+            {
+              loader.root()->print(drop);
+              return 1;
+            }));
+        }
+    }
+
+  return 0;
+}
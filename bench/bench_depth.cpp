@@ -0,0 +1,77 @@
+/**
+ * \file bench_depth.cpp
+ * Parsing of the text made of nested arrays and objects of the given
+ * depth, from shallow records up to a single value nested 100000 times.
+ * The maximum depth of the loader is raised to the deepest text.
+ */
+
+#include <litejson.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/**
+ * Array of the nested values, depth counts the root array and the
+ * innermost array of the scalars
+ */
+static std::string make_nested(size_t size, size_t depth)
+{
+  std::string text = "[";
+  std::string open;
+  std::string close;
+
+  for (size_t i = 2; i < depth; i++)
+    {
+      open += i % 2 == 0 ? "{\"k\": " : "[";
+      close = (i % 2 == 0 ? "}" : "]") + close;
+    }
+
+  do
+    text += open + "[1.5, \"s\", true]" + close + ",";
+  while (text.size() < size);
+  text.back() = ']';
+  return text;
+}
+
+template<class F>
+static void run(const std::string& name, const std::string& text, int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for (int r = 0; r < rounds; r++)
+    if (!f())
+      {
+        std::cout << name << "\tfailed" << std::endl;
+        std::exit(1);
+      }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << text.size() * rounds / seconds / 1e6 << " MB/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16 * 1024 * 1024;
+  litejson::json_loader loader;
+
+  loader.set_max_depth(100001);
+  for (size_t depth : { 2, 8, 64, 1024, 100000 })
+    {
+      std::string text = make_nested(size, depth);
+
+      run("depth " + std::to_string(depth) + "\tsingle pass", text, 5, [&]()
+        {
+          return loader.load(text);
+        });
+
+      run("depth " + std::to_string(depth) + "\ttwo pass", text, 2, [&]()
+        {
+          return loader.load(text, litejson::json_loader::pm_two_pass);
+        });
+    }
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * \file bench_iterate.cpp
+ * Walk over the array of one million records: entries by index with
+ * as_array(), by range-for and by std::accumulate over the typed access
+ * without exceptions. Allocations are counted by operator new.
+ */
+
+#include <litejson.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <string>
+
+static size_t alloc_count;
+
+void* operator new(size_t size)
+{
+  void* p;
+
+  alloc_count++;
+  if ((p = std::malloc(size != 0 ? size : 1)) == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+template<class F>
+static void run(const char* name, const litejson::json_value& root, int rounds, F f)
+{
+  size_t before = alloc_count;
+  int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int r = 0; r < rounds; r++)
+    sum += f(root);
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << seconds / rounds / root.size() * 1e9 << " ns/entry\t"
+            << (alloc_count - before) / rounds << " allocations\t(" << sum << ")" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  int records = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::string text = "[";
+  litejson::json_loader loader;
+
+  for (int i = 0; i < records; i++)
+    text += std::string(i != 0 ? "," : "") + "{\"id\":" + std::to_string(i) + ",\"on\":" + (i % 3 != 0 ? "true" : "false") + "}";
+  text += "]";
+  if (!loader.load(text))
+    return 1;
+
+  run("as_array(i)", *loader.root(), 10, [](const litejson::json_value& root)
+    {
+      int64_t sum = 0;
+      const litejson::json_value* item;
+
+      for (int i = 0; (item = root.as_array(i)) != nullptr; i++)
+        if (item->as_object("on")->as_boolean())
+          sum += item->as_object("id")->as_int64();
+      return sum;
+    });
+
+  run("range-for", *loader.root(), 10, [](const litejson::json_value& root)
+    {
+      int64_t sum = 0;
+
+      for (const litejson::json_value& item : root)
+        if (item.as_object("on")->as_boolean())
+          sum += item.as_object("id")->as_int64();
+      return sum;
+    });
+
+  run("accumulate, get()", *loader.root(), 10, [](const litejson::json_value& root)
+    {
+      return std::accumulate(root.begin(), root.end(), int64_t(0), [](int64_t sum, const litejson::json_value& item)
+        {
+          bool on = false;
+          int64_t id = 0;
+
+          for (const litejson::json_member& member : item.members())
+            if (member.name.as_string_view() == "on")
+              member.value.get(on);
+            else if (member.name.as_string_view() == "id")
+              member.value.get(id);
+          return on ? sum + id : sum;
+        });
+    });
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * \file bench_keys.cpp
+ * Loading of the catalog (array of objects) whose records repeat the
+ * same long keys: keys copied into the arena against keys taken from
+ * the intern table. Prints parse speed, memory of the arenas, memory
+ * saved by the table and the time of the lookups by the plain and by
+ * the interned key.
+ */
+
+#include <litejson.h>
+#include <json_key_table.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+static const char* const names[] = { "product_identifier", "product_display_name", "manufacturer_name",
+                                     "warehouse_location_code", "quantity_available", "unit_price_amount",
+                                     "unit_price_currency", "last_inventory_update", "shipping_weight_grams",
+                                     "is_discontinued_item" };
+
+/**
+ * Catalog of the records
+ */
+static std::string make_catalog(int records)
+{
+  std::string text = "[";
+
+  for (int i = 0; i < records; i++)
+    {
+      text += i != 0 ? ",\n{" : "{";
+      for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++)
+        text += std::string(k != 0 ? ", \"" : "\"") + names[k] + "\": " + std::to_string(i * 10 + k);
+      text += "}";
+    }
+  return text + "]";
+}
+
+static void run(const char* name, const std::string& text, std::shared_ptr<litejson::json_key_table> keys)
+{
+  litejson::json_loader loader;
+  std::string_view plain = names[7];
+  std::string_view interned = keys ? keys->intern(plain) : plain;
+  const litejson::json_value* root;
+  int64_t sum = 0;
+  size_t size;
+
+  loader.set_key_table(keys);
+  loader.enable_stats(true);
+
+  auto start = std::chrono::steady_clock::now();
+
+  loader.load(text);
+
+  auto parsed = std::chrono::steady_clock::now();
+
+  root = loader.root();
+  size = loader.stats()->nodes[litejson::json_value::t_object];
+  for (int r = 0; r < 10; r++)
+    for (size_t i = 0; i < size; i++)
+      sum += root->as_array(i)->as_object(plain)->as_int64();
+
+  auto looked = std::chrono::steady_clock::now();
+
+  for (int r = 0; r < 10; r++)
+    for (size_t i = 0; i < size; i++)
+      sum += root->as_array(i)->as_object(interned)->as_int64();
+
+  auto done = std::chrono::steady_clock::now();
+
+  std::cout << name << "\t" << text.size() / std::chrono::duration<double>(parsed - start).count() / 1e6 << " MB/s\t"
+            << "arena " << loader.stats()->allocated / 1024 << " KB\tsaved " << loader.stats()->key_bytes_saved / 1024
+            << " KB\tlookup " << std::chrono::duration<double>(looked - parsed).count() / (10 * size) * 1e9 << " ns\t"
+            << "interned lookup " << std::chrono::duration<double>(done - looked).count() / (10 * size) * 1e9 << " ns"
+            << "\t(" << sum << ")" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  int records = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::string text = make_catalog(records);
+
+  run("copied keys", text, nullptr);
+  run("interned keys", text, std::make_shared<litejson::json_key_table>());
+  return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * \file bench_lookup.cpp
+ * Object member lookup: std::map against the flat members of small
+ * objects and the hash index of large ones. Path lookup: chain of
+ * as_object() calls against at_pointer() and compiled json_pointer.
+ */
+
+#include <litejson.h>
+#include <json_pointer.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+template<class F>
+static void run(const char* name, const std::string& what, size_t lookups, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  long sum = f();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << what << "\t" << lookups / seconds / 1e6
+            << " Mlookups/s\t(checksum " << sum << ")" << std::endl;
+}
+
+static void bench(size_t members)
+{
+  const size_t lookups = 20000000;
+  std::map<std::string, litejson::json_value*> map;
+  std::vector<std::string> keys;
+  std::vector<uint32_t> hashes;
+  std::string text = "{";
+  litejson::json_loader loader;
+
+  for (size_t i = 0; i < members; i++)
+    {
+      keys.push_back("configuration.key." + std::to_string(i));
+      hashes.push_back(litejson::json_value::hash(keys.back()));
+      text += (i != 0 ? ", \"" : "\"") + keys.back() + "\" : " + std::to_string(i);
+    }
+  text += "}";
+
+  loader.load(text);
+  for (size_t i = 0; i < members; i++)
+    map[keys[i]] = loader.root()->as_object(keys[i]);
+
+  run("std::map", std::to_string(members) + " members", lookups, [&]()
+    {
+      long sum = 0;
+
+      for (size_t i = 0; i < lookups; i++)
+        sum += map.find(keys[i % members])->second->as_integer();
+      return sum;
+    });
+
+  run("as_object", std::to_string(members) + " members", lookups, [&]()
+    {
+      long sum = 0;
+
+      for (size_t i = 0; i < lookups; i++)
+        sum += loader.root()->as_object(keys[i % members])->as_integer();
+      return sum;
+    });
+
+  run("as_object hashed", std::to_string(members) + " members", lookups, [&]()
+    {
+      long sum = 0;
+
+      for (size_t i = 0; i < lookups; i++)
+        sum += loader.root()->as_object(keys[i % members], hashes[i % members])->as_integer();
+      return sum;
+    });
+}
+
+static void bench_path()
+{
+  const size_t lookups = 10000000;
+  std::string text = "{\"config\": {\"servers\": [";
+  litejson::json_loader loader;
+
+  for (int i = 0; i < 8; i++)
+    text += std::string(i != 0 ? "," : "") + "{\"name\": \"s" + std::to_string(i) + "\", \"limits\": {\"rps\": " + std::to_string(i) + "}}";
+  text += "]}}";
+  loader.load(text);
+
+  const litejson::json_value& root = *loader.root();
+  litejson::json_pointer pointer("/config/servers/3/limits/rps");
+
+  run("as_object chain", "5 segments", lookups, [&]()
+    {
+      long sum = 0;
+
+      for (size_t i = 0; i < lookups; i++)
+        sum += root.as_object(std::string("config"))->as_object(std::string("servers"))->as_array(3)
+          ->as_object(std::string("limits"))->as_object(std::string("rps"))->as_integer();
+      return sum;
+    });
+
+  run("at_pointer", "5 segments", lookups, [&]()
+    {
+      long sum = 0;
+
+      for (size_t i = 0; i < lookups; i++)
+        sum += root.at_pointer("/config/servers/3/limits/rps")->as_integer();
+      return sum;
+    });
+
+  run("json_pointer", "5 segments", lookups, [&]()
+    {
+      long sum = 0;
+
+      for (size_t i = 0; i < lookups; i++)
+        sum += pointer.resolve(root)->as_integer();
+      return sum;
+    });
+}
+
+int main()
+{
+  bench(8);
+  bench(64);
+  bench(10000);
+  bench_path();
+  return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * \file bench_numbers.cpp
+ * Numbers parsed per second: parse_number() against the old
+ * atof-to-float conversion of the token text.
+ */
+
+#include <json_number.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> make_numbers(size_t count)
+{
+  std::vector<std::string> numbers;
+  std::mt19937_64 rng(42);
+
+  numbers.reserve(count);
+  for (size_t i = 0; i < count; i++)
+    {
+      switch (i % 4)
+        {
+
+        case 0:                                         // Small integers
+          numbers.push_back(std::to_string(rng() % 100000));
+          break;
+
+        case 1:                                         // Identifiers above 2^24
+          numbers.push_back(std::to_string(rng() >> 8));
+          break;
+
+        case 2:                                         // Prices
+          numbers.push_back(std::to_string(rng() % 100000) + "." + std::to_string(rng() % 100));
+          break;
+
+        default:                                        // Scientific
+          numbers.push_back(std::to_string(rng() % 1000) + ".125e-" + std::to_string(rng() % 30));
+          break;
+
+        }
+    }
+
+  return numbers;
+}
+
+template<class F>
+static double run(const char* name, const std::vector<std::string>& numbers, int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  double sum = 0;
+
+  for (int r = 0; r < rounds; r++)
+    for (auto& n : numbers)
+      sum += f(n);
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double rate = numbers.size() * rounds / seconds;
+
+  std::cout << name << "\t" << rate / 1e6 << " Mnumbers/s\t(checksum " << sum << ")" << std::endl;
+  return rate;
+}
+
+int main(int argc, char** argv)
+{
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  std::vector<std::string> numbers = make_numbers(count);
+  std::string scratch;
+  size_t lost = 0;
+
+  double old_rate = run("atof", numbers, 5, [&](const std::string& n)
+    {
+      scratch.assign(n.data(), n.size());               // Old path copies the token
+      return double((float)std::atof(scratch.c_str()));
+    });
+
+  double new_rate = run("parse_number", numbers, 5, [&](const std::string& n)
+    {
+      litejson::json_value val;
+
+      litejson::parse_number(n.data(), n.data() + n.size(), val);
+      return val.as_double();
+    });
+
+  for (size_t i = 1; i < numbers.size(); i += 4)        // Identifiers damaged by float
+    {
+      litejson::json_value val;
+
+      litejson::parse_number(numbers[i].data(), numbers[i].data() + numbers[i].size(), val);
+      if ((unsigned long long)(float)std::atof(numbers[i].c_str()) != val.as_uint64())
+        lost++;
+    }
+
+  std::cout << "speedup\t" << new_rate / old_rate << std::endl;
+  std::cout << "identifiers changed by float\t" << lost << " of " << numbers.size() / 4 << std::endl;
+  return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * \file bench_scan.cpp
+ * Throughput of the structural scanner and of the parsers on
+ * whitespace-heavy pretty-printed text. Lazy load reads only
+ * a few fields. Parallel load uses all hardware threads.
+ */
+
+#include <litejson.h>
+#include <json_scan.h>
+#include <json_push_parser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::string make_pretty(size_t size)
+{
+  std::string text = "[\n";
+  std::string indent(16, ' ');
+  int i = 0;
+
+  while (text.size() < size)
+    {
+      text += indent + "{\n";
+      text += indent + indent + "\"id\"        :        " + std::to_string(i) + ",\n";
+      text += indent + indent + "\"name\"      :        \"item number " + std::to_string(i) + "\",\n";
+      text += indent + indent + "\"tags\"      :        [ \"a\" ,   \"b\" ,   \"c\" ],\n";
+      text += indent + indent + "\"enabled\"   :        true\n";
+      text += indent + "},\n";
+      i++;
+    }
+  text += indent + "null\n]\n";
+  return text;
+}
+
+template<class F>
+static void run(const char* name, const std::string& text, int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for (int r = 0; r < rounds; r++)
+    if (!f())
+      {
+        std::cout << name << "\tfailed" << std::endl;
+        std::exit(1);
+      }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << text.size() * rounds / seconds / 1e6 << " MB/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64 * 1024 * 1024;
+  std::string text = make_pretty(size);
+  std::vector<uint32_t> index;
+  litejson::json_loader loader;
+
+  run("bracket_index", text, 5, [&]()
+    {
+      return litejson::bracket_index(text.data(), text.size(), index);
+    });
+
+  run("skip_whitespace", text, 5, [&]()
+    {
+      const char* p = text.data();
+      const char* end = p + text.size();
+      int lines = 0;
+
+      while (p != end)                                  // Alternate whitespace and other runs
+        {
+          p = litejson::skip_whitespace(p, end, &lines);
+          while (p != end && !litejson::is_class(*p, litejson::c_space))
+            p++;
+        }
+      return lines > 0;
+    });
+
+  run("load single pass", text, 3, [&]()
+    {
+      return loader.load(text, litejson::json_loader::pm_single_pass);
+    });
+
+  run("load parallel", text, 3, [&]()
+    {
+      return loader.load(text, litejson::json_loader::pm_parallel);
+    });
+
+  run("load two pass", text, 1, [&]()
+    {
+      return loader.load(text, litejson::json_loader::pm_two_pass);
+    });
+
+  run("push parser, 16 KB chunks", text, 3, [&]()
+    {
+      litejson::json_push_parser parser;
+
+      for (size_t offset = 0; offset < text.size(); offset += 16384)
+        if (!parser.feed(text.data() + offset, std::min<size_t>(16384, text.size() - offset)))
+          return false;
+      return parser.finish();
+    });
+
+  run("load lazy, read 12 fields", text, 3, [&]()
+    {
+      if (!loader.load(text, litejson::json_loader::pm_lazy))
+        return false;
+      for (int i = 0; i < 12; i++)
+        if (loader.root()->as_array(i * 1000)->as_object("name") == nullptr)
+          return false;
+      return true;
+    });
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * \file bench_snapshot.cpp
+ * Readers of the shared configuration while it is reloaded every
+ * millisecond: json_snapshot against shared_mutex and atomic
+ * shared_ptr, on 1, 2, 4... threads.
+ */
+
+#include <json_snapshot.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::unique_ptr<litejson::json_document> make_config(int version)
+{
+  std::string text = "{\"version\": " + std::to_string(version);
+
+  for (int i = 0; i < 50; i++)
+    text += ", \"option" + std::to_string(i) + "\": " + std::to_string(i);
+  return std::unique_ptr<litejson::json_document>(new litejson::json_document(text + "}"));
+}
+
+/**
+ * Run readers on the threads and reload the configuration by the caller
+ *
+ * \param [in] read    -- Reader, returns a value of the configuration
+ * \param [in] reload  -- Publishes new version
+ */
+template<class R, class P>
+static void run(const char* name, unsigned threads, double seconds, R read, P reload)
+{
+  std::atomic<bool> stop(false);
+  std::atomic<size_t> reads(0);
+  std::vector<std::thread> pool;
+  int version = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned t = 0; t < threads; t++)
+    pool.emplace_back([&]()
+      {
+        size_t n = 0;
+        int64_t sum = 0;
+
+        while (!stop.load(std::memory_order_relaxed))
+          {
+            for (int i = 0; i < 256; i++)
+              sum += read();
+            n += 256;
+          }
+        reads += n + (sum == -1);
+      });
+
+  while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds)
+    {
+      reload(++version);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  stop = true;
+  for (std::thread& t : pool)
+    t.join();
+
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << ", " << threads << " threads\t" << reads / elapsed / 1e6 << " Mreads/s\t"
+            << version << " reloads" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 1.0;
+  unsigned cores = std::thread::hardware_concurrency();
+
+  for (unsigned threads = 1; threads <= std::max(cores, 4u); threads *= 2)
+    {
+      litejson::json_snapshot snapshot;
+
+      snapshot.publish(make_config(0));
+      run("json_snapshot", threads, seconds, [&]()
+        {
+          litejson::json_snapshot::reader config = snapshot.read();
+
+          return config->root()->as_object("option7")->as_int64();
+        },
+        [&](int version)
+        {
+          snapshot.publish(make_config(version));
+        });
+
+      std::shared_mutex mutex;
+      std::unique_ptr<litejson::json_document> locked = make_config(0);
+
+      run("shared_mutex", threads, seconds, [&]()
+        {
+          std::shared_lock<std::shared_mutex> lock(mutex);
+
+          return locked->root()->as_object("option7")->as_int64();
+        },
+        [&](int version)
+        {
+          std::unique_ptr<litejson::json_document> config = make_config(version);
+          std::unique_lock<std::shared_mutex> lock(mutex);
+
+          locked.swap(config);
+        });
+
+      std::shared_ptr<const litejson::json_document> shared(make_config(0));
+
+      run("atomic shared_ptr", threads, seconds, [&]()
+        {
+          std::shared_ptr<const litejson::json_document> config = std::atomic_load(&shared);
+
+          return config->root()->as_object("option7")->as_int64();
+        },
+        [&](int version)
+        {
+          std::atomic_store(&shared, std::shared_ptr<const litejson::json_document>(make_config(version)));
+        });
+    }
+
+  return 0;
+}
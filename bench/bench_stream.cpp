@@ -0,0 +1,81 @@
+/**
+ * \file bench_stream.cpp
+ * JSON Lines reading: next() one by one and for_each() on 1, 2, 4...
+ * threads up to the number of processors.
+ */
+
+#include <json_stream.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static std::string make_lines(size_t size)
+{
+  std::string text;
+  int i = 0;
+
+  while (text.size() < size)
+    {
+      text += "{\"ts\": " + std::to_string(1700000000 + i) + ", \"level\": \"info\", \"user\": " + std::to_string(i % 977) +
+              ", \"msg\": \"request served in " + std::to_string(i % 300) + " ms\", \"ok\": true, \"tags\": [\"a\", \"b\"]}\n";
+      i++;
+    }
+  return text;
+}
+
+template<class F>
+static void run(const std::string& name, const std::string& text, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  size_t records = f();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << text.size() / seconds / 1e6 << " MB/s\t" << records / seconds / 1e6
+            << " Mrecords/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64 * 1024 * 1024;
+  std::string text = make_lines(size);
+  unsigned cores = std::thread::hardware_concurrency();
+  litejson::json_stream stream;
+
+  stream.open(text);
+
+  run("next", text, [&]()
+    {
+      size_t records = 0;
+
+      stream.open(text);
+      while (stream.next() != nullptr)
+        records++;
+      return records;
+    });
+
+  for (unsigned threads = 1; threads <= (cores != 0 ? cores : 1); threads *= 2)
+    {
+      run("for_each ordered, " + std::to_string(threads) + " threads", text, [&]()
+        {
+          size_t records = 0;
+
+          stream.for_each([&](litejson::json_value&, size_t) { records++; }, threads);
+          return records;
+        });
+
+      run("for_each unordered, " + std::to_string(threads) + " threads", text, [&]()
+        {
+          std::atomic<size_t> records(0);
+
+          stream.for_each([&](litejson::json_value&, size_t) { records++; },
+                          threads, litejson::json_stream::o_unordered);
+          return size_t(records);
+        });
+    }
+
+  return 0;
+}
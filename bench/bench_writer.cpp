@@ -0,0 +1,84 @@
+/**
+ * \file bench_writer.cpp
+ * Output speed of json_writer in compact and pretty modes against
+ * the legacy json_value::print().
+ */
+
+#include <litejson.h>
+#include <json_writer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::string make_document(size_t size)
+{
+  std::string text = "[";
+  int i = 0;
+
+  while (text.size() < size)
+    {
+      text += "{\"id\": " + std::to_string(i) + ", \"price\": " + std::to_string(i * 0.37) +
+              ", \"name\": \"item \\\"" + std::to_string(i) + "\\\"\\n\", \"tags\": [\"a\", \"b\"], \"enabled\": true},";
+      i++;
+    }
+  text += "null]";
+  return text;
+}
+
+template<class F>
+static void run(const char* name, int rounds, F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  size_t bytes = 0;
+
+  for (int r = 0; r < rounds; r++)
+    bytes += f();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << name << "\t" << bytes / seconds / 1e6 << " MB/s\t(" << bytes / rounds << " bytes)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32 * 1024 * 1024;
+  litejson::json_loader loader;
+
+  if (!loader.load(make_document(size)))
+    return 1;
+
+  const litejson::json_value& root = *loader.root();
+
+  run("print", 1, [&]()
+    {
+      std::ostringstream stream;
+
+      root.print(stream);
+      return stream.str().size();
+    });
+
+  run("writer compact", 5, [&]()
+    {
+      return litejson::json_writer::to_string(root).size();
+    });
+
+  run("writer indent 2", 5, [&]()
+    {
+      return litejson::json_writer::to_string(root, 2).size();
+    });
+
+  run("writer sink", 5, [&]()
+    {
+      size_t bytes = 0;
+      litejson::json_writer writer([&](std::string_view text) { bytes += text.size(); });
+
+      writer.write(root);
+      writer.flush();
+      return bytes;
+    });
+
+  return 0;
+}
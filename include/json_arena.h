@@ -0,0 +1,121 @@
+/**
+ * \file json_arena.h
+ */
+
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace litejson
+{
+
+  /**
+   * Monotonic memory arena. Memory is taken from large blocks and is
+   * never returned one by one: the whole arena is released at once
+   * by clear() or by the destructor. clear() keeps the last block, so
+   * the next document of the same loader reuses it.
+   */
+  class json_arena
+  {
+
+  private:
+
+    struct block
+    {
+      block* next;                                      //!< Previous block in the chain
+      size_t size;                                      //!< Size of the block data
+    };
+
+    block* m_blocks;                                    //!< Chain of the blocks, last one first
+    char* m_ptr;                                        //!< Free space in the current block
+    char* m_end;                                        //!< End of the current block
+    size_t m_block_size;                                //!< Size of the next block
+    size_t m_block_count;                               //!< Number of the allocated blocks
+    size_t m_bytes_reserved;                            //!< Bytes taken from the system
+
+    /**
+     * Take new block from the system
+     *
+     * \param [in] size -- Minimum size of the block
+     */
+    void grow(size_t size);
+
+  public:
+
+    /**
+     * Make empty arena. No memory is taken until the first allocation.
+     *
+     * \param [in] block_size -- Size of the first block
+     */
+    explicit json_arena(size_t block_size = 64 * 1024);
+
+    /**
+     * Destructor. Release all blocks.
+     */
+    ~json_arena();
+
+    json_arena(const json_arena&) = delete;
+    json_arena& operator=(const json_arena&) = delete;
+
+    /**
+     * Allocate memory from the arena
+     *
+     * \param [in] size  -- Size in bytes
+     * \param [in] align -- Alignment of the memory
+     * \return Pointer to the memory. Never nullptr.
+     */
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t))
+    {
+      uintptr_t p = (reinterpret_cast<uintptr_t>(m_ptr) + align - 1) & ~(uintptr_t)(align - 1);
+
+      if (m_ptr == nullptr || p + size > reinterpret_cast<uintptr_t>(m_end))
+        {
+          grow(size + align);
+          p = (reinterpret_cast<uintptr_t>(m_ptr) + align - 1) & ~(uintptr_t)(align - 1);
+        }
+
+      m_ptr = reinterpret_cast<char*>(p + size);
+      return reinterpret_cast<void*>(p);
+    }
+
+    /**
+     * Construct object inside the arena. Destructor of the object is
+     * never called, so the object must keep all of its memory inside
+     * the arena.
+     */
+    template<class T, class... Args>
+    T* make(Args&&... args)
+    {
+      return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Release all blocks except the last one, which is the largest, and
+     * start over in it
+     */
+    void clear();
+
+    /**
+     * Release all blocks
+     */
+    void release();
+
+    /**
+     * Number of the blocks taken from the system
+     */
+    size_t block_count() const { return m_block_count; }
+
+    /**
+     * Bytes taken from the system
+     */
+    size_t bytes_reserved() const { return m_bytes_reserved; }
+
+  };
+
+}
+
+#endif // JSON_ARENA_H
@@ -0,0 +1,427 @@
+/**
+ * \file json_bind.h
+ * Reading of the JSON text straight into C++ structs and writing them
+ * back, without the tree of json_value. Fields of the struct are
+ * declared once by the specialization of json_fields:
+ *
+ *   struct server { std::string host; uint16_t port; std::optional<double> weight; };
+ *
+ *   template<> struct litejson::json_fields<server>
+ *   {
+ *     static constexpr auto list = std::make_tuple(litejson::field("host", &server::host),
+ *                                                  litejson::field("port", &server::port),
+ *                                                  litejson::field("weight", &server::weight));
+ *   };
+ *
+ *   server s;
+ *   std::string error;
+ *
+ *   if (!litejson::from_json(text, s, &error)) ...
+ *   std::string text = litejson::to_json(s, 2);
+ *
+ * Supported members are bool, integers (range checked), floating point,
+ * std::string, std::vector, std::optional (null or missing member),
+ * std::map with string keys and other bound structs. Unknown members
+ * are skipped, later duplicate wins, missing members are errors unless
+ * they are std::optional or declared by optional_field().
+ */
+
+#ifndef JSON_BIND_H
+#define JSON_BIND_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "json_reader.h"
+#include "json_writer.h"
+
+namespace litejson
+{
+
+  /**
+   * Hash of the member name. Hashes of the fields are computed at
+   * compile time, so the name of the member is hashed once and then
+   * compared with the constants.
+   */
+  constexpr uint32_t bind_hash(std::string_view name)
+  {
+    uint32_t h = 2166136261u;
+
+    for (size_t i = 0; i < name.size(); i++)
+      h = (h ^ uint8_t(name[i])) * 16777619u;
+    return h;
+  }
+
+  template<class T>
+  struct is_optional : std::false_type {};
+
+  template<class T>
+  struct is_optional<std::optional<T>> : std::true_type {};
+
+  /**
+   * Member of the struct with its JSON name
+   */
+  template<class S, class M>
+  struct json_field
+  {
+    std::string_view name;                              //!< Name in JSON
+    M S::* member;                                      //!< Member of the struct
+    bool required;                                      //!< Missing member is an error
+    uint32_t hash;                                      //!< bind_hash() of the name
+  };
+
+  /**
+   * Field which must be present unless it is std::optional
+   */
+  template<class S, class M>
+  constexpr json_field<S, M> field(std::string_view name, M S::* member)
+  {
+    return json_field<S, M>{name, member, !is_optional<M>::value, bind_hash(name)};
+  }
+
+  /**
+   * Field which keeps its value when the member is missing
+   */
+  template<class S, class M>
+  constexpr json_field<S, M> optional_field(std::string_view name, M S::* member)
+  {
+    return json_field<S, M>{name, member, false, bind_hash(name)};
+  }
+
+  /**
+   * Fields of the bound struct. Specialization must have the static
+   * constexpr tuple of field() named list.
+   */
+  template<class T>
+  struct json_fields {};
+
+  template<class T, class = void>
+  struct is_bound : std::false_type {};
+
+  template<class T>
+  struct is_bound<T, std::void_t<decltype(json_fields<T>::list)>> : std::true_type {};
+
+  /**
+   * Reading and writing of the type, specialized below
+   */
+  template<class T, class = void>
+  struct json_binder;
+
+  template<>
+  struct json_binder<bool>
+  {
+    static bool read(json_reader& r, bool& val) { return r.read(val); }
+    static void write(json_writer& w, bool val) { w.value(val); }
+  };
+
+  template<class T>
+  struct json_binder<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+  {
+    static bool read(json_reader& r, T& val)
+    {
+      if constexpr (std::is_signed<T>::value)
+        {
+          int64_t i;
+
+          if (!r.read(i))
+            return false;
+          if (i < int64_t(std::numeric_limits<T>::min()) || i > int64_t(std::numeric_limits<T>::max()))
+            return r.fail("integer out of range");
+          val = T(i);
+        }
+      else
+        {
+          uint64_t u;
+
+          if (!r.read(u))
+            return false;
+          if (u > uint64_t(std::numeric_limits<T>::max()))
+            return r.fail("integer out of range");
+          val = T(u);
+        }
+      return true;
+    }
+
+    static void write(json_writer& w, T val)
+    {
+      if constexpr (std::is_signed<T>::value)
+        w.value((long long)val);
+      else
+        w.value((unsigned long long)val);
+    }
+  };
+
+  template<class T>
+  struct json_binder<T, std::enable_if_t<std::is_floating_point<T>::value>>
+  {
+    static bool read(json_reader& r, T& val)
+    {
+      double d;
+
+      if (!r.read(d))
+        return false;
+      val = T(d);
+      return true;
+    }
+
+    static void write(json_writer& w, T val)
+    {
+      if constexpr (std::is_same<T, float>::value)      // Shortest form of float, not of its double
+        w.value(val);
+      else
+        w.value(double(val));
+    }
+  };
+
+  template<>
+  struct json_binder<std::string>
+  {
+    static bool read(json_reader& r, std::string& val) { return r.read(val); }
+    static void write(json_writer& w, const std::string& val) { w.value(std::string_view(val)); }
+  };
+
+  template<class T>
+  struct json_binder<std::optional<T>>
+  {
+    static bool read(json_reader& r, std::optional<T>& val)
+    {
+      if (r.peek() == json_reader::tk_null)
+        {
+          val.reset();
+          return r.read_null();
+        }
+      return json_binder<T>::read(r, val.emplace());
+    }
+
+    static void write(json_writer& w, const std::optional<T>& val)
+    {
+      if (val)
+        json_binder<T>::write(w, *val);
+      else
+        w.null_value();
+    }
+  };
+
+  template<class T, class A>
+  struct json_binder<std::vector<T, A>>
+  {
+    static bool read(json_reader& r, std::vector<T, A>& val)
+    {
+      size_t index = 0;
+
+      val.clear();
+      if (!r.begin_array())
+        return false;
+
+      while (r.next_item())
+        {
+          T item{};                                     // std::vector<bool> has no references to the items
+
+          r.push_path(index++);
+          if (!json_binder<T>::read(r, item))
+            return false;
+          val.push_back(std::move(item));
+          r.pop_path();
+        }
+      return !r.bad();
+    }
+
+    static void write(json_writer& w, const std::vector<T, A>& val)
+    {
+      w.begin_array();
+      for (const T& item : val)
+        json_binder<T>::write(w, item);
+      w.end_array();
+    }
+  };
+
+  template<class T, class C, class A>
+  struct json_binder<std::map<std::string, T, C, A>>
+  {
+    static bool read(json_reader& r, std::map<std::string, T, C, A>& val)
+    {
+      std::string_view name;
+      std::string key;
+
+      val.clear();
+      if (!r.begin_object())
+        return false;
+
+      while (r.next_member(name))
+        {
+          key = name;                                   // Name is overwritten by the value
+          r.push_path(key);
+          if (!json_binder<T>::read(r, val[key]))
+            return false;
+          r.pop_path();
+        }
+      return !r.bad();
+    }
+
+    static void write(json_writer& w, const std::map<std::string, T, C, A>& val)
+    {
+      w.begin_object();
+      for (const auto& member : val)
+        {
+          w.key(member.first);
+          json_binder<T>::write(w, member.second);
+        }
+      w.end_object();
+    }
+  };
+
+  template<class T>
+  struct json_binder<T, std::enable_if_t<is_bound<T>::value>>
+  {
+    typedef std::decay_t<decltype(json_fields<T>::list)> list_t;
+
+    static const size_t count = std::tuple_size<list_t>::value;
+
+    /**
+     * Read the member if it is the field I
+     *
+     * \return true if the name is of the field
+     */
+    template<size_t I>
+    static bool read_field(json_reader& r, T& val, std::string_view name, uint32_t hash,
+                           std::bitset<count>& seen, bool& ok)
+    {
+      const auto& f = std::get<I>(json_fields<T>::list);
+      typedef std::decay_t<decltype(val.*(f.member))> member_t;
+
+      if (f.hash != hash || f.name != name)
+        return false;
+
+      r.push_path(f.name);
+      ok = json_binder<member_t>::read(r, val.*(f.member));
+      r.pop_path();
+      seen.set(I);
+      return true;
+    }
+
+    template<size_t... I>
+    static bool read_members(json_reader& r, T& val, std::index_sequence<I...>)
+    {
+      std::bitset<count> seen;
+      std::string_view name;
+      bool ok;
+
+      if (!r.begin_object())
+        return false;
+
+      while (r.next_member(name))
+        {
+          uint32_t hash = bind_hash(name);
+
+          ok = true;
+          if (!(read_field<I>(r, val, name, hash, seen, ok) || ...) && !r.skip())    // Unknown members are skipped
+            return false;
+          if (!ok)
+            return false;
+        }
+      if (r.bad())
+        return false;
+
+      // Missing members
+      return ((seen.test(I) || !std::get<I>(json_fields<T>::list).required ||
+               r.fail("missing member ``" + std::string(std::get<I>(json_fields<T>::list).name) + "''")) && ...);
+    }
+
+    template<size_t... I>
+    static void write_members(json_writer& w, const T& val, std::index_sequence<I...>)
+    {
+      w.begin_object();
+      (write_field(w, std::get<I>(json_fields<T>::list), val), ...);
+      w.end_object();
+    }
+
+    template<class F>
+    static void write_field(json_writer& w, const F& f, const T& val)
+    {
+      typedef std::decay_t<decltype(val.*(f.member))> member_t;
+
+      if constexpr (is_optional<member_t>::value)       // Missing member means empty value
+        if (!(val.*(f.member)))
+          return;
+
+      w.key(f.name);
+      json_binder<member_t>::write(w, val.*(f.member));
+    }
+
+    static bool read(json_reader& r, T& val)
+    {
+      return read_members(r, val, std::make_index_sequence<count>());
+    }
+
+    static void write(json_writer& w, const T& val)
+    {
+      write_members(w, val, std::make_index_sequence<count>());
+    }
+  };
+
+  /**
+   * Read the whole text into the value
+   *
+   * \param [in] text   -- JSON text
+   * \param [out] val   -- Value of the bound or supported type
+   * \param [out] error -- Message of the error with line and JSON pointer, may be nullptr
+   * \return Return result of operation. false on error, val may be partly read.
+   */
+  template<class T>
+  bool from_json(std::string_view text, T& val, std::string* error = nullptr)
+  {
+    json_reader r(text);
+
+    if (json_binder<T>::read(r, val) && r.finish())
+      return true;
+
+    if (error != nullptr)
+      *error = r.error();
+    return false;
+  }
+
+  /**
+   * Write the value as JSON text
+   *
+   * \param [in] val    -- Value of the bound or supported type
+   * \param [in] indent -- Spaces per nesting level, 0 for compact text
+   * \return JSON text
+   */
+  template<class T>
+  std::string to_json(const T& val, int indent = 0)
+  {
+    json_writer w(indent);
+
+    json_binder<T>::write(w, val);
+    return w.str();
+  }
+
+  /**
+   * Write the value as JSON text into the sink by parts
+   *
+   * \param [in] val    -- Value of the bound or supported type
+   * \param [in] sink   -- Receiver of the text
+   * \param [in] indent -- Spaces per nesting level, 0 for compact text
+   */
+  template<class T>
+  void to_json(const T& val, json_writer::sink_t sink, int indent = 0)
+  {
+    json_writer w(std::move(sink), indent);
+
+    json_binder<T>::write(w, val);
+    w.flush();
+  }
+
+}
+
+#endif // JSON_BIND_H
@@ -0,0 +1,190 @@
+/**
+ * \file json_cache.h
+ */
+
+#ifndef JSON_CACHE_H
+#define JSON_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "json_value.h"
+#include "json_mapped_file.h"
+
+namespace litejson
+{
+
+  /**
+   * Binary cache of the parsed tree. The file holds json_value nodes,
+   * member arrays with their hash index and string characters in one
+   * block, where pointers are stored as offsets from the block. Opening
+   * maps the file copy-on-write and adds the block address to every
+   * pointer listed in the relocation table, so no parsing and no
+   * allocation is done. The format depends on the platform (byte
+   * order and size of pointer) and such files are refused by open().
+   * The file is trusted: offsets are range checked, the tree is not.
+   */
+  class json_cache
+  {
+
+  public:
+
+    static const uint32_t format_version = 1;           //!< Changed on every layout change
+
+  private:
+
+    /**
+     * Header of the file. The block and the relocation table follow it.
+     */
+    struct header
+    {
+      char magic[8];                                    //!< "LJSONBIN"
+      uint32_t version;                                 //!< format_version
+      uint32_t byte_order;                              //!< 0x01020304 in the byte order of the writer
+      uint32_t value_size;                              //!< sizeof(json_value)
+      uint32_t pointer_size;                            //!< sizeof(void*)
+      uint64_t source_size;                             //!< Size of the source text, 0 if unknown
+      int64_t source_time;                              //!< Modification time of the source text, ns
+      uint64_t root;                                    //!< Offset of the root node in the block
+      uint64_t block_size;                              //!< Size of the block
+      uint64_t relocations;                             //!< Number of the pointers in the block
+    };
+
+    json_mapped_file m_file;                            //!< Mapped cache file
+    const json_value* m_root;                           //!< Root of the tree
+
+    /**
+     * Size of the node storage in the block, see copy()
+     */
+    static size_t measure(const json_value& val);
+
+    /**
+     * Copy the node into the block
+     *
+     * \param [out] dst          -- Node in the block
+     * \param [in] src           -- Source node
+     * \param [in, out] free     -- Free space of the block
+     * \param [out] relocations  -- Addresses of the pointers in the block
+     */
+    static void copy(json_value& dst, const json_value& src, char*& free, std::vector<char*>& relocations);
+
+    /**
+     * Size and modification time of the file
+     *
+     * \param [in] file_name -- Name of the file
+     * \param [out] size     -- Size of the file
+     * \param [out] time     -- Modification time, ns
+     * \return Return result of operation. false if file does not exist.
+     */
+    static bool file_time(const std::string& file_name, uint64_t* size, int64_t* time);
+
+    /**
+     * Write the tree into the cache file. The file is written under
+     * a unique temporary name and renamed over the cache.
+     *
+     * \param [in] root        -- Root of the tree
+     * \param [in] cache_name  -- Name of the cache file
+     * \param [in] source_size -- Size of the JSON text file, 0 if unknown
+     * \param [in] source_time -- Modification time of the JSON text file, ns
+     * \return Return result of operation. false on error.
+     */
+    static bool write_file(const json_value& root, const std::string& cache_name, uint64_t source_size, int64_t source_time);
+
+  public:
+
+    /**
+     * Make empty cache
+     */
+    json_cache();
+
+    /**
+     * Open cache file
+     *
+     * \param [in] cache_name -- Name of the cache file
+     */
+    explicit json_cache(const std::string& cache_name);
+
+    json_cache(const json_cache&) = delete;
+    json_cache& operator=(const json_cache&) = delete;
+
+    /**
+     * Open cache file. Previous file is closed.
+     *
+     * \param [in] cache_name -- Name of the cache file
+     * \return Return result of operation. false on error or if the
+     *         file is made by another version or platform.
+     */
+    bool open(const std::string& cache_name);
+
+    /**
+     * Open cache of the JSON text file. Cache is made again if it is
+     * missing, bad or older than the text.
+     *
+     * \param [in] source_name -- Name of the JSON text file
+     * \param [in] cache_name  -- Name of the cache file
+     * \return Return result of operation. false if there is no valid cache
+     *         and the text can not be parsed or cache can not be written.
+     */
+    bool open_or_build(const std::string& source_name, const std::string& cache_name);
+
+    /**
+     * Close the file. Nodes of the tree are not valid after that.
+     */
+    void close();
+
+    /**
+     * Root of the tree or nullptr if no file is opened
+     */
+    const json_value* root() const { return m_root; }
+
+    /**
+     * Write the tree into the cache file. Lazy nodes are parsed.
+     *
+     * \param [in] root        -- Root of the tree
+     * \param [in] cache_name  -- Name of the cache file
+     * \param [in] source_name -- Name of the JSON text file to check staleness, may be empty.
+     *                           Its size and time are taken now, so the tree must be
+     *                           parsed from the text as it is now.
+     * \return Return result of operation. false on error.
+     */
+    static bool write(const json_value& root, const std::string& cache_name,
+                      const std::string& source_name = std::string());
+
+    /**
+     * Parse JSON text file and write its cache. Size and time of the
+     * text are taken before it is read, and checked again after the
+     * cache is written.
+     *
+     * \param [in] source_name -- Name of the JSON text file
+     * \param [in] cache_name  -- Name of the cache file
+     * \return Return result of operation. false on error or if the
+     *         text changed meanwhile (the written cache is stale then).
+     */
+    static bool build(const std::string& source_name, const std::string& cache_name);
+
+    /**
+     * Write the opened tree back as JSON text
+     *
+     * \param [in] file_name -- Name of the JSON text file
+     * \param [in] indent    -- Indentation, 0 for compact text
+     * \return Return result of operation. false on error.
+     */
+    bool write_text(const std::string& file_name, int indent = 0) const;
+
+    /**
+     * Is cache missing, bad or made of other version of the text.
+     * Only the header of the cache is read.
+     *
+     * \param [in] cache_name  -- Name of the cache file
+     * \param [in] source_name -- Name of the JSON text file
+     * \return true if the cache must be made again
+     */
+    static bool is_stale(const std::string& cache_name, const std::string& source_name);
+
+  };
+
+}
+
+#endif // JSON_CACHE_H
@@ -0,0 +1,72 @@
+/**
+ * \file json_document.h
+ */
+
+#ifndef JSON_DOCUMENT_H
+#define JSON_DOCUMENT_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "litejson.h"
+
+namespace litejson
+{
+
+  /**
+   * Read-only JSON document. The tree is parsed completely by the
+   * constructor and is never changed after that, so const document
+   * may be read from any number of threads at once. Lazy mode is not
+   * allowed, the text is parsed in single pass instead.
+   */
+  class json_document
+  {
+
+  private:
+
+    json_loader m_loader;                               //!< Owner of the tree
+
+  public:
+
+    /**
+     * Parse text in memory
+     *
+     * \param [in] text     -- JSON text, not kept
+     * \param [in] mode     -- Parsing mode
+     */
+    explicit json_document(std::string_view text, json_loader::parse_mode_t mode = json_loader::pm_single_pass);
+
+    json_document(const json_document&) = delete;
+    json_document& operator=(const json_document&) = delete;
+
+    /**
+     * Parse text file. The file stays mapped with the document and long
+     * strings without escapes refer to it instead of being copied.
+     *
+     * \param [in] file_name -- Name of the JSON text file
+     * \param [in] mode      -- Parsing mode
+     * \return New document, check bad() before use
+     */
+    static std::unique_ptr<json_document> from_file(const std::string& file_name,
+                                                    json_loader::parse_mode_t mode = json_loader::pm_single_pass);
+
+    /**
+     * Text was not parsed
+     */
+    bool bad() const { return m_loader.root() == nullptr; }
+
+    /**
+     * Root of the tree or nullptr on error
+     */
+    const json_value* root() const { return m_loader.root(); }
+
+  private:
+
+    json_document() = default;
+
+  };
+
+}
+
+#endif // JSON_DOCUMENT_H
@@ -0,0 +1,163 @@
+/**
+ * \file json_key_table.h
+ */
+
+#ifndef JSON_KEY_TABLE_H
+#define JSON_KEY_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+#include "json_arena.h"
+
+namespace litejson
+{
+
+  /**
+   * Intern table of the object keys. Every distinct key is stored once,
+   * the loaders which use the table (see json_loader::set_key_table())
+   * make member names refer to that storage instead of copying every
+   * occurrence into their arenas. Names found by the interned key are
+   * compared by pointer. Short keys are stored inline by json_value and
+   * are never interned. The table may be shared by loaders on several
+   * threads and must live as long as their trees.
+   *
+   * The table is split into shards chosen by the key hash, every shard
+   * has its own lock. Keys which are in the table already are found
+   * under the shared lock, so the loaders on several threads wait for
+   * each other only when they add new keys to the same shard.
+   *
+   * The table grows with every distinct key till clear(). Tables fed
+   * by untrusted text should be limited by set_max_bytes(), keys over
+   * the limit are not stored and the loaders copy them as without the
+   * table.
+   */
+  class json_key_table
+  {
+
+  public:
+
+    static const size_t shard_count = 16;               //!< Number of the shards, power of two
+
+  private:
+
+    /**
+     * Slot of the hash table. Open addressing with linear probing.
+     */
+    struct slot
+    {
+      uint32_t hash;                                    //!< json_value::hash() of the key
+      uint32_t size;                                    //!< Length of the key
+      const char* chars;                                //!< Zero terminated key, nullptr if slot is empty
+    };
+
+    /**
+     * Part of the table with its own lock
+     */
+    struct shard
+    {
+      mutable std::shared_mutex lock;                   //!< Shared by lookups, exclusive for changes
+      json_arena arena;                                 //!< Characters of the keys
+      std::vector<slot> slots;                          //!< Hash table, size is power of two
+      size_t count;                                     //!< Number of the keys
+      size_t bytes;                                     //!< Bytes of the stored keys
+      std::atomic<size_t> hits;                         //!< Occurrences found in the shard
+      std::atomic<size_t> saved;                        //!< Bytes of the occurrences found in the shard
+    };
+
+    shard m_shards[shard_count];                        //!< Shards chosen by the high bits of the hash
+    std::atomic<size_t> m_bytes;                        //!< Bytes of the keys of all the shards
+    size_t m_max_bytes;                                 //!< Limit of m_bytes, keys over it are not stored
+
+    /**
+     * Shard of the key hash. Slots are chosen by the low bits.
+     */
+    shard& shard_of(uint32_t hash) { return m_shards[hash >> 28 & (shard_count - 1)]; }
+    const shard& shard_of(uint32_t hash) const { return m_shards[hash >> 28 & (shard_count - 1)]; }
+
+    /**
+     * Slot of the key or empty slot where it goes
+     */
+    static size_t find_slot(const shard& s, std::string_view key, uint32_t hash);
+
+    /**
+     * Double the hash table of the shard
+     */
+    static void rehash(shard& s);
+
+    /**
+     * Count the occurrence of the key found in the shard
+     */
+    static std::string_view hit(shard& s, size_t i, bool* added);
+
+  public:
+
+    /**
+     * Make empty table
+     */
+    json_key_table();
+
+    json_key_table(const json_key_table&) = delete;
+    json_key_table& operator=(const json_key_table&) = delete;
+
+    /**
+     * Stored copy of the key. The key is added if it is new.
+     *
+     * \param [in] key    -- Key
+     * \param [out] added -- The key is new, may be nullptr
+     * \return Key in the table, valid till clear(), or string_view with
+     *         nullptr data if the key is new and the table is full
+     */
+    std::string_view intern(std::string_view key, bool* added = nullptr);
+
+    /**
+     * Stored copy of the key without adding it
+     *
+     * \param [in] key -- Key
+     * \return Key in the table or string_view with nullptr data if there is none
+     */
+    std::string_view find(std::string_view key) const;
+
+    /**
+     * Delete all the keys. Trees which refer to them must be deleted before.
+     */
+    void clear();
+
+    /**
+     * Limit the bytes of the stored keys. Set it before the table is
+     * shared with the loaders.
+     *
+     * \param [in] bytes -- Limit, not limited by default
+     */
+    void set_max_bytes(size_t bytes) { m_max_bytes = bytes; }
+
+    /**
+     * Number of the distinct keys
+     */
+    size_t size() const;
+
+    /**
+     * Bytes of the stored keys with their terminators
+     */
+    size_t bytes() const { return m_bytes; }
+
+    /**
+     * Number of the intern() calls which found the key
+     */
+    size_t hits() const;
+
+    /**
+     * Bytes which would be copied by the intern() calls which found the
+     * key, i.e. memory saved by the table
+     */
+    size_t bytes_saved() const;
+
+  };
+
+}
+
+#endif // JSON_KEY_TABLE_H
@@ -0,0 +1,142 @@
+/**
+ * \file json_lazy.h
+ */
+
+#ifndef JSON_LAZY_H
+#define JSON_LAZY_H
+
+#include "json_value.h"
+#include "json_arena.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace litejson
+{
+
+  /**
+   * Lazy JSON document. Single structural pass finds the bounds of all
+   * arrays and objects, then every container is parsed only when it is
+   * accessed: its scalars are extracted and nested containers are left
+   * lazy and skipped by offset. The text must not change or go away
+   * while the document is used.
+   */
+  class json_lazy
+  {
+
+  private:
+
+    /**
+     * Bounds of the array or object. Containers are numbered in the
+     * order of their opening brackets.
+     */
+    struct container
+    {
+      uint32_t open;                                    //!< Offset of the opening bracket
+      uint32_t close;                                   //!< Offset of the closing bracket
+      uint32_t next;                                    //!< Number of the first container after this one
+    };
+
+    const char* m_text;                                 //!< JSON text
+    size_t m_size;                                      //!< Size of the text
+    json_arena* m_arena;                                //!< Memory of the parsed nodes
+    std::vector<container> m_containers;                //!< All containers of the text
+    std::vector<json_value> m_items;                    //!< Entries of the container being parsed
+    std::string m_scratch;                              //!< Reusable buffer for string extraction
+    size_t m_expanded;                                  //!< Number of the parsed containers
+    size_t m_max_depth;                                 //!< Maximum nesting of arrays and objects
+    bool m_too_deep;                                    //!< Last open() failed on the nesting
+
+    /**
+     * Extract string. String without escapes refers to the text.
+     *
+     * \param [in] p   -- Opening quote
+     * \param [in] end -- End of the text
+     * \param [out] val -- Extracted value
+     * \return Pointer after the closing quote or nullptr on error
+     */
+    const char* parse_string(const char* p, const char* end, json_value& val);
+
+    /**
+     * Extract string, number or literal
+     *
+     * \param [in] p   -- First character of the value
+     * \param [in] end -- End of the text
+     * \param [out] val -- Extracted value
+     * \return Pointer after the value or nullptr on error
+     */
+    const char* parse_scalar(const char* p, const char* end, json_value& val);
+
+    /**
+     * Make lazy array or object
+     *
+     * \param [in] index -- Number of the container
+     */
+    json_value make_lazy(uint32_t index);
+
+    [[noreturn]] static void syntax_error();
+
+  public:
+
+    /**
+     * Make empty document
+     */
+    json_lazy();
+
+    json_lazy(const json_lazy&) = delete;
+    json_lazy& operator=(const json_lazy&) = delete;
+
+    /**
+     * Find the containers and make the lazy root value. The text is
+     * not copied. Syntax errors inside of containers are found on access.
+     *
+     * \param [in] text  -- JSON text, less than 4 GB
+     * \param [in] size  -- Size of the text
+     * \param [in] arena -- Arena for the parsed nodes
+     * \param [out] root -- Root value
+     * \return Return result of operation. false if strings or brackets do not match
+     *         or nesting is too deep.
+     */
+    bool open(const char* text, size_t size, json_arena& arena, json_value& root);
+
+    /**
+     * Set maximum nesting of arrays and objects, checked by open() for
+     * all the containers of the text. Not limited by default.
+     *
+     * \param [in] depth -- Maximum depth, the root array or object is at depth 1
+     */
+    void set_max_depth(size_t depth) { m_max_depth = depth; }
+
+    /**
+     * Did the last open() fail because nesting is too deep
+     */
+    bool too_deep() const { return m_too_deep; }
+
+    /**
+     * Forget the text. Values of the document must not be accessed any more.
+     */
+    void close();
+
+    /**
+     * Parse lazy array or object in place. Throw std::runtime_error on syntax error.
+     *
+     * \param [in, out] val -- Lazy value
+     */
+    void materialize(json_value& val);
+
+    /**
+     * Number of all the arrays and objects of the document
+     */
+    size_t container_count() const { return m_containers.size(); }
+
+    /**
+     * Number of the arrays and objects parsed so far
+     */
+    size_t expanded_count() const { return m_expanded; }
+
+  };
+
+}
+
+#endif // JSON_LAZY_H
@@ -0,0 +1,91 @@
+/**
+ * \file json_mapped_file.h
+ */
+
+#ifndef JSON_MAPPED_FILE_H
+#define JSON_MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace litejson
+{
+
+  /**
+   * Read-only view of the whole file contents. The file is mapped into
+   * memory where the system supports it, otherwise it is read into the
+   * internal buffer. Pipes, devices and other files which are not
+   * regular are always read till the end.
+   */
+  class json_mapped_file
+  {
+
+  private:
+
+    const char* m_data;                                 //!< First byte of the file
+    size_t m_size;                                      //!< Size of the file
+    bool m_mapped;                                      //!< Data is mapped, not read
+    bool m_writable;                                    //!< Data may be changed
+    std::string m_buffer;                               //!< Fallback storage
+
+  public:
+
+    /**
+     * Make closed file view
+     */
+    json_mapped_file();
+
+    /**
+     * Open and map file
+     *
+     * \param [in] file_name -- Name of the file
+     */
+    explicit json_mapped_file(const std::string& file_name);
+
+    /**
+     * Destructor. Unmap the file.
+     */
+    ~json_mapped_file();
+
+    json_mapped_file(const json_mapped_file&) = delete;
+    json_mapped_file& operator=(const json_mapped_file&) = delete;
+
+    /**
+     * Open and map file. Previous file is closed.
+     *
+     * \param [in] file_name     -- Name of the file
+     * \param [in] copy_on_write -- Data may be changed, changes are not written to the file
+     * \return Return result of operation. false on error.
+     */
+    bool open(const std::string& file_name, bool copy_on_write = false);
+
+    /**
+     * Unmap the file
+     */
+    void close();
+
+    /**
+     * Is file opened
+     */
+    bool is_open() const { return m_data != nullptr; }
+
+    /**
+     * Contents of the file
+     */
+    const char* data() const { return m_data; }
+
+    /**
+     * Contents of the file opened with copy_on_write, otherwise nullptr
+     */
+    char* writable_data() { return m_writable ? const_cast<char*>(m_data) : nullptr; }
+
+    /**
+     * Size of the file in bytes
+     */
+    size_t size() const { return m_size; }
+
+  };
+
+}
+
+#endif // JSON_MAPPED_FILE_H
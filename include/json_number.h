@@ -0,0 +1,28 @@
+/**
+ * \file json_number.h
+ */
+
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+#include "json_value.h"
+
+namespace litejson
+{
+
+  /**
+   * Extract JSON number from the text. Integers which fit 64 bits are
+   * stored exactly as int64 or uint64, other numbers are converted to
+   * the nearest double. Conversion does not depend on the locale.
+   *
+   * \param [in] begin -- First character of the number
+   * \param [in] end   -- End of the text
+   * \param [out] val  -- Extracted number
+   * \return Pointer to the first character after the number or nullptr
+   *         if the text is not a valid JSON number.
+   */
+  const char* parse_number(const char* begin, const char* end, json_value& val);
+
+}
+
+#endif // JSON_NUMBER_H
@@ -0,0 +1,102 @@
+/**
+ * \file json_pointer.h
+ */
+
+#ifndef JSON_POINTER_H
+#define JSON_POINTER_H
+
+#include "json_value.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace litejson
+{
+
+  /**
+   * Compiled JSON Pointer (RFC 6901). The pointer is split, unescaped
+   * and hashed once, then it may be resolved against any number of
+   * documents without allocations.
+   */
+  class json_pointer
+  {
+
+  private:
+
+    /**
+     * Reference token of the pointer
+     */
+    struct segment
+    {
+      size_t offset;                                    //!< Offset of the unescaped name in m_names
+      size_t size;                                      //!< Size of the name
+      uint32_t hash;                                    //!< json_value::hash() of the name
+      int64_t index;                                    //!< Array index or -1 if name is not an index
+    };
+
+    std::string m_names;                                //!< Unescaped names of all the segments
+    std::vector<segment> m_segments;                    //!< Segments from the root
+
+  public:
+
+    /**
+     * Empty pointer, refers to the whole document
+     */
+    json_pointer() = default;
+
+    /**
+     * Compile the pointer. Throw std::runtime_error if the pointer is not valid.
+     *
+     * \param [in] pointer -- JSON Pointer, e.g. "/servers/3/limits/rps"
+     */
+    explicit json_pointer(std::string_view pointer);
+
+    /**
+     * Compile the pointer
+     *
+     * \param [in] pointer -- JSON Pointer
+     * \return Return result of operation. false if the pointer is not valid.
+     */
+    bool compile(std::string_view pointer);
+
+    /**
+     * Find the value the pointer refers to
+     *
+     * \param [in] root -- Root of the document
+     * \return Value or nullptr if there is no such value
+     */
+    const json_value* resolve(const json_value& root) const;
+
+    json_value* resolve(json_value& root) const
+    {
+      return const_cast<json_value*>(resolve(static_cast<const json_value&>(root)));
+    }
+
+    /**
+     * Number of the reference tokens
+     */
+    size_t size() const { return m_segments.size(); }
+
+    /**
+     * Unescape reference token: ~1 is '/', ~0 is '~'
+     *
+     * \param [in] token -- Token without the leading '/'
+     * \param [out] out  -- Unescaped token
+     * \return Return result of operation. false if there is wrong escape.
+     */
+    static bool unescape(std::string_view token, std::string& out);
+
+    /**
+     * Array index of the reference token
+     *
+     * \param [in] token -- Unescaped token
+     * \return Index or -1 if the token is not an index (leading zeros, "-", etc.)
+     */
+    static int64_t array_index(std::string_view token);
+
+  };
+
+}
+
+#endif // JSON_POINTER_H
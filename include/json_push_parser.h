@@ -0,0 +1,190 @@
+/**
+ * \file json_push_parser.h
+ */
+
+#ifndef JSON_PUSH_PARSER_H
+#define JSON_PUSH_PARSER_H
+
+#include "json_value.h"
+#include "json_arena.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace litejson
+{
+
+  /**
+   * Incremental JSON parser. The text is given by chunks of any size as
+   * it arrives, parsing state is kept between the calls, so a token may
+   * be split anywhere, even inside of an escape sequence.
+   */
+  class json_push_parser
+  {
+
+  public:
+
+    static const size_t default_max_depth = 1024;       //!< As json_loader::default_max_depth
+
+  private:
+
+    /**
+     * What is expected next
+     */
+    enum state_t
+    {
+      s_value,                                          //!< Any value
+      s_first_value,                                    //!< Value or ']'
+      s_first_key,                                      //!< Key or '}'
+      s_key,                                            //!< Key
+      s_colon,                                          //!< ':'
+      s_next,                                           //!< ',' or closing bracket
+      s_done                                            //!< Only whitespaces
+    };
+
+    /**
+     * Kind of the unfinished token
+     */
+    enum token_t
+    {
+      k_none,                                           //!< No unfinished token
+      k_string,                                         //!< String value
+      k_key,                                            //!< Key of the object entry
+      k_number,                                         //!< Number
+      k_literal                                         //!< null, true or false
+    };
+
+    /**
+     * Unfinished array or object
+     */
+    struct frame
+    {
+      size_t base;                                      //!< Stack size before the first entry
+      bool object;                                      //!< Object or array
+    };
+
+    json_value* m_root;                                 //!< Root element of the JSON tree
+    json_arena m_arena;                                 //!< Memory of all nodes of the tree
+    bool m_badbit;                                      //!< Parsing failed
+    int m_line;                                         //!< Current line number
+    state_t m_state;                                    //!< Parser state
+    token_t m_kind;                                     //!< Kind of the unfinished token
+    bool m_escape;                                      //!< Chunk ends with backslash inside string
+    std::string m_token;                                //!< Characters of the unfinished token
+    std::string m_scratch;                              //!< Reusable buffer for string extraction
+    std::vector<json_value> m_stack;                    //!< Values of the unfinished arrays and objects
+    std::vector<frame> m_frames;                        //!< Unfinished arrays and objects
+    size_t m_max_depth;                                 //!< Maximum nesting of arrays and objects
+    std::ostream* m_log;                                //!< Stream for the error messages or nullptr
+
+    /**
+     * Continue the token. If the token ends in the chunk, its value is
+     * put onto the stack, otherwise its characters are kept.
+     *
+     * \param [in] p   -- First unprocessed character of the token
+     * \param [in] end -- End of the chunk
+     * \return Pointer after the token, end if the token is not finished or nullptr on error
+     */
+    const char* scan_token(const char* p, const char* end);
+
+    /**
+     * Make value of the complete token
+     *
+     * \param [in] begin -- Token text, string body ends with the closing quote
+     * \param [in] end   -- End of the token text
+     * \return Return result of operation. false on error.
+     */
+    bool end_token(const char* begin, const char* end);
+
+    /**
+     * Choose state after the complete value
+     */
+    void end_value();
+
+    /**
+     * Replace entries on top of the stack with the array or object
+     */
+    void end_container();
+
+    /**
+     * Report error and stop parsing
+     */
+    bool error(const char* what);
+
+  public:
+
+    /**
+     * Make parser of the new document
+     */
+    json_push_parser();
+
+    /**
+     * Destructor. Delete the tree.
+     */
+    ~json_push_parser();
+
+    json_push_parser(const json_push_parser&) = delete;
+    json_push_parser& operator=(const json_push_parser&) = delete;
+
+    /**
+     * Parse next chunk of the text
+     *
+     * \param [in] data -- Chunk
+     * \param [in] size -- Size of the chunk
+     * \return Return result of operation. false on error.
+     */
+    bool feed(const char* data, size_t size);
+
+    /**
+     * Parse next chunk of the text
+     *
+     * \param [in] text -- Chunk
+     * \return Return result of operation. false on error.
+     */
+    bool feed(std::string_view text) { return feed(text.data(), text.size()); }
+
+    /**
+     * Finish the text. Check that the document is complete and make the tree.
+     *
+     * \return Return result of operation. false on error.
+     */
+    bool finish();
+
+    /**
+     * Delete the tree and start new document
+     */
+    void reset();
+
+    /**
+     * Return state of the parser. If true is return, the text is not valid.
+     */
+    bool bad() const { return m_badbit; }
+
+    /**
+     * Root element of the JSON tree or nullptr before successful finish().
+     * The tree is owned by the parser.
+     */
+    json_value* root() { return m_root; }
+
+    /**
+     * Set maximum nesting of arrays and objects. Deeper text fails to
+     * parse with an error.
+     *
+     * \param [in] depth -- Maximum depth, the root array or object is at depth 1
+     */
+    void set_max_depth(size_t depth) { m_max_depth = depth; }
+
+    /**
+     * Set stream for the error messages, std::cerr by default
+     *
+     * \param [in] log -- Stream, nullptr to drop the messages
+     */
+    void set_log(std::ostream* log) { m_log = log; }
+
+  };
+
+}
+
+#endif // JSON_PUSH_PARSER_H
@@ -0,0 +1,199 @@
+/**
+ * \file json_reader.h
+ */
+
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace litejson
+{
+
+  class json_value;
+
+  /**
+   * Pull reader of the JSON text. Values are read one by one straight
+   * from the text, no tree is made. The first error stops the reader,
+   * its message tells the line and the JSON pointer of the value.
+   *
+   * Arrays and objects are read by the loops:
+   *
+   *   if (reader.begin_array())
+   *     while (reader.next_item())
+   *       reader.read(x);
+   *
+   *   if (reader.begin_object())
+   *     while (reader.next_member(key))
+   *       reader.skip();
+   */
+  class json_reader
+  {
+
+  public:
+
+    /**
+     * Kind of the next value
+     */
+    enum token_t
+    {
+      tk_null,
+      tk_boolean,
+      tk_number,
+      tk_string,
+      tk_array,
+      tk_object,
+      tk_none                                           //!< No value or error
+    };
+
+    static const size_t default_max_depth = 1024;       //!< As json_loader::default_max_depth
+
+  private:
+
+    /**
+     * Part of the JSON pointer of the current value
+     */
+    struct path_entry
+    {
+      std::string_view name;                            //!< Member name, empty for array item
+      size_t index;                                     //!< Array index
+    };
+
+    const char* m_it;                                   //!< Current character
+    const char* m_end;                                  //!< End of the text
+    int m_line;                                         //!< Current line
+    bool m_first;                                       //!< No entries of the current array or object are read
+    std::string m_error;                                //!< First error
+    std::string m_key;                                  //!< Storage of the escaped member name
+    std::vector<path_entry> m_path;                     //!< Pointer of the current value
+    size_t m_max_depth;                                 //!< Maximum nesting of arrays and objects in skip()
+
+    /**
+     * Skip whitespaces, return the next character or 0 at the end
+     */
+    char next_char();
+
+    /**
+     * Consume the literal
+     */
+    bool read_literal(const char* literal, size_t size);
+
+    /**
+     * Read any number
+     *
+     * \param [out] num      -- Number
+     * \param [out] negative -- Number has minus sign
+     */
+    bool read_number(json_value& num, bool* negative);
+
+  public:
+
+    /**
+     * Start reading of the text
+     *
+     * \param [in] text -- JSON text, must live as long as the reader
+     */
+    explicit json_reader(std::string_view text);
+
+    /**
+     * Is there an error
+     */
+    bool bad() const { return !m_error.empty(); }
+
+    /**
+     * Message of the first error, empty if there is none
+     */
+    const std::string& error() const { return m_error; }
+
+    /**
+     * Stop reading with the error. Only the first error is kept.
+     *
+     * \param [in] what -- Description of the error
+     * \return false
+     */
+    bool fail(const std::string& what);
+
+    /**
+     * Kind of the next value, nothing is consumed
+     */
+    token_t peek();
+
+    /**
+     * Consume null
+     */
+    bool read_null();
+
+    /**
+     * Read the value of the type. Integers are range checked.
+     *
+     * \param [out] val -- Value
+     * \return Return result of operation. false on error.
+     */
+    bool read(bool& val);
+    bool read(double& val);
+    bool read(int64_t& val);
+    bool read(uint64_t& val);
+    bool read(std::string& val);
+
+    /**
+     * Skip the value with all its contents. Nested arrays and objects
+     * are counted, not recursed, and nesting deeper than the maximum
+     * depth is an error.
+     */
+    bool skip();
+
+    /**
+     * Set maximum nesting of arrays and objects inside the skipped value
+     *
+     * \param [in] depth -- Maximum depth, default_max_depth by default
+     */
+    void set_max_depth(size_t depth) { m_max_depth = depth; }
+
+    /**
+     * Consume the opening bracket of the array
+     */
+    bool begin_array();
+
+    /**
+     * Move to the next item of the array. The closing bracket is consumed
+     * when there are no more items.
+     *
+     * \return true if there is an item to read
+     */
+    bool next_item();
+
+    /**
+     * Consume the opening bracket of the object
+     */
+    bool begin_object();
+
+    /**
+     * Read the name of the next member of the object. The closing
+     * bracket is consumed when there are no more members.
+     *
+     * \param [out] name -- Name, valid till the next read or skip
+     * \return true if there is a member value to read
+     */
+    bool next_member(std::string_view& name);
+
+    /**
+     * Check that nothing but whitespace is left
+     */
+    bool finish();
+
+    /**
+     * Add the member name or array index to the pointer of the errors
+     */
+    void push_path(std::string_view name) { m_path.push_back(path_entry{name, 0}); }
+    void push_path(size_t index) { m_path.push_back(path_entry{std::string_view(), index}); }
+    void pop_path() { m_path.pop_back(); }
+
+  };
+
+}
+
+#endif // JSON_READER_H
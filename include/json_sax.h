@@ -0,0 +1,325 @@
+/**
+ * \file json_sax.h
+ * Event parser of the JSON text. The parser calls the handler for every
+ * value, no tree is made, so memory does not depend on the size of the
+ * text, only on the nesting depth. The handler is a template parameter
+ * and its calls are inlined. Every call returns false to stop parsing.
+ *
+ *   struct sum : litejson::json_sax_handler
+ *   {
+ *     double total = 0;
+ *
+ *     bool number(const litejson::json_value& num) { total += num.as_double(); return true; }
+ *   };
+ *
+ *   sum handler;
+ *   litejson::json_sax_parser<sum> parser(handler);
+ *
+ *   if (!parser.parse(text)) ...
+ */
+
+#ifndef JSON_SAX_H
+#define JSON_SAX_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json_value.h"
+#include "json_number.h"
+#include "json_scan.h"
+#include "json_string.h"
+
+namespace litejson
+{
+
+  /**
+   * Handler which accepts all events. Handlers derive from it and hide
+   * the calls they need.
+   */
+  struct json_sax_handler
+  {
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number(const json_value&) { return true; }      //!< Number value, see json_value::as_int64() etc.
+    bool string(std::string_view) { return true; }       //!< Decoded string, valid during the call
+    bool key(std::string_view) { return true; }          //!< Decoded member name, valid during the call
+    bool begin_object() { return true; }
+    bool end_object() { return true; }
+    bool begin_array() { return true; }
+    bool end_array() { return true; }
+  };
+
+  /**
+   * Event parser. Nesting is kept on the explicit stack, so deep text
+   * does not overflow the call stack.
+   */
+  template<class Handler>
+  class json_sax_parser
+  {
+
+  public:
+
+    static const size_t default_max_depth = 1024;      //!< Deeper text is an error
+
+  private:
+
+    /**
+     * What is expected next
+     */
+    enum state_t
+    {
+      s_value,                                          //!< Any value
+      s_key,                                            //!< Member name
+      s_next                                            //!< ',' or closing bracket
+    };
+
+    Handler& m_handler;                                 //!< Receiver of the events
+    const char* m_it;                                   //!< Current character
+    const char* m_end;                                  //!< End of the text
+    int m_line;                                         //!< Current line
+    bool m_aborted;                                     //!< Handler stopped parsing
+    size_t m_max_depth;                                 //!< Maximum nesting of arrays and objects
+    std::string m_error;                                //!< Message of the error
+    std::string m_scratch;                              //!< Storage of the decoded string
+    std::vector<bool> m_stack;                          //!< Unfinished containers, true for object
+
+    /**
+     * Report error and stop parsing
+     */
+    bool error(const char* what)
+    {
+      m_error = "Syntax error (" + std::to_string(m_line) + "): " + what;
+      return false;
+    }
+
+    /**
+     * Report the stop by the handler
+     */
+    bool abort()
+    {
+      m_aborted = true;
+      m_error = "Parsing stopped by the handler (" + std::to_string(m_line) + ")";
+      return false;
+    }
+
+    /**
+     * Skip whitespaces, return the next character or 0 at the end
+     */
+    char next_char()
+    {
+      m_it = skip_whitespace(m_it, m_end, &m_line);
+      return m_it != m_end ? *m_it : 0;
+    }
+
+    /**
+     * Read the string at the quote. Strings without escapes are not copied.
+     */
+    bool read_string(std::string_view& str)
+    {
+      const char* begin = m_it + 1;
+      const char* stop = scan_string(begin, m_end);
+
+      if (stop != m_end && *stop == '\"' && validate_utf8(begin, stop - begin))
+        {
+          str = std::string_view(begin, stop - begin);
+          m_it = stop + 1;
+          return true;
+        }
+
+      stop = decode_string(begin, m_end, m_scratch);
+      if (stop == nullptr)
+        return error("Bad string");
+      str = m_scratch;
+      m_it = stop;
+      return true;
+    }
+
+    /**
+     * Consume the literal
+     */
+    bool read_literal(const char* literal, size_t size)
+    {
+      if (size_t(m_end - m_it) < size || std::memcmp(m_it, literal, size) != 0)
+        return error("Value expected");
+      m_it += size;
+      return true;
+    }
+
+    /**
+     * Open array or object
+     */
+    bool push(bool object)
+    {
+      if (m_stack.size() >= m_max_depth)
+        return error("Nesting is too deep");
+      m_stack.push_back(object);
+      m_it++;
+      return true;
+    }
+
+    /**
+     * Parse the value which is not an array or object
+     */
+    bool read_scalar(char c)
+    {
+      std::string_view str;
+      json_value num;
+      const char* next;
+
+      switch (c)
+        {
+
+        case '\"':
+          return read_string(str) && (m_handler.string(str) || abort());
+
+        case 'n':
+          return read_literal("null", 4) && (m_handler.null() || abort());
+
+        case 't':
+          return read_literal("true", 4) && (m_handler.boolean(true) || abort());
+
+        case 'f':
+          return read_literal("false", 5) && (m_handler.boolean(false) || abort());
+
+        case 0:
+          return error("Unexpected end of file");
+
+        default:
+          next = parse_number(m_it, m_end, num);
+          if (next == nullptr)
+            return error("Value expected");
+          m_it = next;
+          return m_handler.number(num) || abort();
+
+        }
+    }
+
+  public:
+
+    /**
+     * Make parser
+     *
+     * \param [in] handler -- Receiver of the events, must live as long as the parser
+     */
+    explicit json_sax_parser(Handler& handler)
+    : m_handler(handler),
+      m_it(nullptr),
+      m_end(nullptr),
+      m_line(1),
+      m_aborted(false),
+      m_max_depth(default_max_depth)
+    {
+    }
+
+    /**
+     * Set maximum nesting of arrays and objects
+     */
+    void set_max_depth(size_t depth) { m_max_depth = depth; }
+
+    /**
+     * Parse the text. Events of the values before an error are already
+     * given to the handler.
+     *
+     * \param [in] text -- JSON text
+     * \return Return result of operation. false on error or if the handler stopped parsing.
+     */
+    bool parse(std::string_view text)
+    {
+      state_t state = s_value;
+      std::string_view str;
+      char c;
+
+      m_it = text.data();
+      m_end = text.data() + text.size();
+      m_line = 1;
+      m_aborted = false;
+      m_error.clear();
+      m_stack.clear();
+
+      do
+        {
+          c = next_char();
+          switch (state)
+            {
+
+            case s_value:
+              if (c == '{')
+                {
+                  if (!push(true) || !(m_handler.begin_object() || abort()))
+                    return false;
+                  if (next_char() == '}')
+                    state = s_next;                     // Closing bracket is consumed below
+                  else
+                    state = s_key;
+                  continue;
+                }
+              if (c == '[')
+                {
+                  if (!push(false) || !(m_handler.begin_array() || abort()))
+                    return false;
+                  if (next_char() == ']')
+                    state = s_next;
+                  continue;
+                }
+              if (!read_scalar(c))
+                return false;
+              state = s_next;
+              break;
+
+            case s_key:
+              if (c != '\"')
+                return error("String expected");
+              if (!read_string(str) || !(m_handler.key(str) || abort()))
+                return false;
+              if (next_char() != ':')
+                return error("``:\'\' expected");
+              m_it++;
+              state = s_value;
+              continue;
+
+            case s_next:
+              if (m_stack.empty())
+                break;
+              if (c == ',')
+                {
+                  m_it++;
+                  state = m_stack.back() ? s_key : s_value;
+                  continue;
+                }
+              if (c == (m_stack.back() ? '}' : ']'))
+                {
+                  m_it++;
+                  m_stack.pop_back();
+                  if (!((c == '}' ? m_handler.end_object() : m_handler.end_array()) || abort()))
+                    return false;
+                  continue;
+                }
+              return error(m_stack.back() ? "``,\'\' or ``}\'\' expected" : "``,\'\' or ``]\'\' expected");
+
+            }
+        }
+      while (!m_stack.empty());
+
+      if (next_char() != 0 || m_it != m_end)
+        return error("Extra characters after the end of JSON value");
+      return true;
+    }
+
+    /**
+     * Did the handler stop parsing
+     */
+    bool aborted() const { return m_aborted; }
+
+    /**
+     * Message of the last error, empty if there is none
+     */
+    const std::string& error() const { return m_error; }
+
+  };
+
+}
+
+#endif // JSON_SAX_H
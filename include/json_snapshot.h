@@ -0,0 +1,135 @@
+/**
+ * \file json_snapshot.h
+ */
+
+#ifndef JSON_SNAPSHOT_H
+#define JSON_SNAPSHOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "json_document.h"
+
+namespace litejson
+{
+
+  /**
+   * Holder of the current version of the document, shared by many
+   * reader threads. Reader takes the version without locks: the
+   * version is announced in a hazard slot of the thread and checked
+   * again, so reading costs two atomic loads and one store. New version
+   * is published by atomic exchange. Old versions are deleted by
+   * publish() or reclaim() when no reader announces them any more.
+   */
+  class json_snapshot
+  {
+
+  public:
+
+    static const unsigned max_nesting = 8;              //!< Readers alive at once in one thread
+
+    /**
+     * Reader of the current version. The version stays alive until the
+     * reader is destroyed. The reader must not be passed to other threads.
+     */
+    class reader
+    {
+
+    private:
+
+      const json_document* m_document;
+      std::atomic<const void*>* m_slot;                 //!< Hazard slot of the thread
+
+      friend class json_snapshot;
+
+      reader(const json_document* document, std::atomic<const void*>* slot)
+      : m_document(document), m_slot(slot) {}
+
+    public:
+
+      reader(reader&& other) noexcept
+      : m_document(other.m_document), m_slot(other.m_slot)
+      {
+        other.m_slot = nullptr;
+      }
+
+      ~reader()
+      {
+        if (m_slot != nullptr)
+          m_slot->store(nullptr, std::memory_order_release);
+      }
+
+      reader(const reader&) = delete;
+      reader& operator=(const reader&) = delete;
+      reader& operator=(reader&&) = delete;
+
+      /**
+       * Document or nullptr if nothing is published
+       */
+      const json_document* get() const { return m_document; }
+      const json_document* operator->() const { return m_document; }
+      const json_document& operator*() const { return *m_document; }
+      explicit operator bool() const { return m_document != nullptr; }
+
+    };
+
+  private:
+
+    std::atomic<const json_document*> m_current;        //!< Published version
+    std::mutex m_mutex;                                 //!< Publishers
+    std::vector<const json_document*> m_retired;        //!< Old versions which may still be read
+
+    /**
+     * Delete retired versions which are not announced by any reader.
+     * Mutex must be locked.
+     */
+    void scan();
+
+  public:
+
+    /**
+     * Make empty holder
+     */
+    json_snapshot();
+
+    /**
+     * Delete all versions. There must be no readers.
+     */
+    ~json_snapshot();
+
+    json_snapshot(const json_snapshot&) = delete;
+    json_snapshot& operator=(const json_snapshot&) = delete;
+
+    /**
+     * Take the current version. Lock-free, may be called from any thread.
+     *
+     * \return Reader of the version
+     */
+    reader read() const;
+
+    /**
+     * Make the document current version. Readers of the old version
+     * keep it until they finish.
+     *
+     * \param [in] document -- New version, may be nullptr
+     */
+    void publish(std::unique_ptr<const json_document> document);
+
+    /**
+     * Delete old versions which have no readers
+     */
+    void reclaim();
+
+    /**
+     * Number of the old versions waiting for their readers
+     */
+    size_t retired();
+
+  };
+
+}
+
+#endif // JSON_SNAPSHOT_H
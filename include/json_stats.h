@@ -0,0 +1,78 @@
+/**
+ * \file json_stats.h
+ * Statistics of the loaded document, see json_loader::enable_stats()
+ */
+
+#ifndef JSON_STATS_H
+#define JSON_STATS_H
+
+#include <cstddef>
+#include <functional>
+
+namespace litejson
+{
+
+  class json_value;
+
+  /**
+   * Counters of the last load. Nodes are counted on the finished tree,
+   * so parsers do not pay for the statistics. Unparsed containers of
+   * the lazy document are counted in lazy_nodes only.
+   */
+  struct json_stats
+  {
+
+    /**
+     * Phases of the load
+     */
+    enum phase_t
+    {
+      ph_read,                                          //!< Mapping or copying of the text
+      ph_lexical,                                       //!< Token list of the two pass mode
+      ph_syntax,                                        //!< Tree of the two pass mode
+      ph_parse,                                         //!< Single pass, parallel or lazy parsing
+      ph_count
+    };
+
+    size_t bytes;                                       //!< Size of the text
+    size_t tokens;                                      //!< Values, names and punctuation
+    size_t nodes[6];                                    //!< Values of every json_value::json_value_type_t
+    size_t lazy_nodes;                                  //!< Arrays and objects which are not parsed yet
+    size_t max_depth;                                   //!< Nesting of arrays and objects, root is 1
+    size_t max_array;                                   //!< Entries of the largest array
+    size_t max_object;                                  //!< Members of the largest object
+    size_t string_bytes;                                //!< Bytes of the strings and member names
+    size_t allocations;                                 //!< Blocks taken by the arenas of the tree
+    size_t allocated;                                   //!< Bytes taken by the arenas of the tree
+    size_t keys_interned;                               //!< Object keys taken from the key table
+    size_t key_bytes_saved;                             //!< Bytes of the keys not copied thanks to the key table
+    double time[ph_count];                              //!< Wall time of every phase, s
+
+    json_stats() { clear(); }
+
+    /**
+     * Reset all counters
+     */
+    void clear();
+
+    /**
+     * Count nodes of the tree
+     *
+     * \param [in] root  -- Root of the tree
+     * \param [in] depth -- Depth of the root
+     */
+    void count_tree(const json_value& root, size_t depth = 1);
+
+    /**
+     * Pass every counter to the function, e.g. to export them
+     * to a metrics system. Names are stable.
+     *
+     * \param [in] f     -- Function of the name and the value
+     */
+    void for_each(const std::function<void(const char* name, double value)>& f) const;
+
+  };
+
+}
+
+#endif // JSON_STATS_H
@@ -0,0 +1,170 @@
+/**
+ * \file json_stream.h
+ */
+
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include "litejson.h"
+#include "json_mapped_file.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <memory>
+
+namespace litejson
+{
+
+  /**
+   * Reader of the JSON Lines (NDJSON) text: one document per line,
+   * blank lines are skipped. The text is split into chunks at line
+   * boundaries, every chunk is parsed into its own arena. Records are
+   * read one by one by next() or all at once by for_each(), which
+   * parses the chunks on several threads.
+   */
+  class json_stream
+  {
+
+  public:
+
+    /**
+     * Order of the records for for_each()
+     */
+    enum order_t
+    {
+      o_ordered,                                        //!< Records in the file order, handler is never called concurrently
+      o_unordered                                       //!< Records as they are parsed, handler must be thread safe
+    };
+
+    /**
+     * Record handler: document and offset of its line in the text
+     */
+    typedef std::function<void(json_value& doc, size_t offset)> handler_t;
+
+  private:
+
+    /**
+     * Parsed chunk
+     */
+    struct batch
+    {
+      json_loader loader;                               //!< Arena of the documents
+      std::vector<json_value*> docs;                    //!< Documents in the chunk order
+      std::vector<size_t> offsets;                      //!< Offsets of the documents in the text
+      size_t bad_offset;                                //!< Offset of the bad record
+      bool good;                                        //!< Whole chunk is parsed
+      bool ready = false;                               //!< Parsed by for_each() and not passed to the handler yet
+    };
+
+    json_mapped_file m_file;                            //!< Mapped file
+    const char* m_data;                                 //!< JSON Lines text
+    size_t m_size;                                      //!< Size of the text
+    size_t m_chunk_size;                                //!< Approximate size of the chunk
+    size_t m_offset;                                    //!< Offset of the next chunk for next()
+    batch m_batch;                                      //!< Current chunk of next()
+    size_t m_current;                                   //!< Number of the next document in m_batch
+    std::shared_ptr<json_key_table> m_keys;             //!< Intern table of the keys of all chunks, may be nullptr
+    size_t m_bad_offset;                                //!< Offset of the bad record
+    bool m_badbit;                                      //!< Bad record is found
+    std::unique_ptr<json_thread_pool> m_pool;           //!< Threads of for_each(), kept between the calls
+    unsigned m_pool_threads;                            //!< Number of threads m_pool is made for, 0 for all processors
+    std::vector<std::unique_ptr<batch>> m_batches;      //!< Chunks of for_each(), their arenas are reused
+
+    /**
+     * End of the chunk which starts at offset, after the new line character
+     */
+    size_t chunk_end(size_t offset) const;
+
+    /**
+     * Parse every line of the chunk. Stop at the first bad record.
+     */
+    void parse_chunk(size_t begin, size_t end, batch& b) const;
+
+  public:
+
+    /**
+     * Make closed stream
+     */
+    json_stream();
+
+    json_stream(const json_stream&) = delete;
+    json_stream& operator=(const json_stream&) = delete;
+
+    /**
+     * Open and map JSON Lines file
+     *
+     * \param [in] file_name -- Name of the file
+     * \return Return result of operation. false on error.
+     */
+    bool open_file(const std::string& file_name);
+
+    /**
+     * Read JSON Lines text from memory. The text is not copied.
+     *
+     * \param [in] text -- JSON Lines text
+     */
+    void open(std::string_view text);
+
+    /**
+     * Close the stream. Documents are deleted.
+     */
+    void close();
+
+    /**
+     * Set approximate size of the chunks
+     *
+     * \param [in] size -- Size in bytes
+     */
+    void set_chunk_size(size_t size) { m_chunk_size = size != 0 ? size : 1; }
+
+    /**
+     * Store long keys of all the records in the intern table, see
+     * json_loader::set_key_table(). The table may be shared with other
+     * streams and loaders.
+     *
+     * \param [in] table -- Intern table, nullptr to copy the keys
+     */
+    void set_key_table(std::shared_ptr<json_key_table> table) { m_keys = std::move(table); }
+
+    /**
+     * Next record. The document is valid till the end of its chunk,
+     * so it may be deleted by the following calls.
+     *
+     * \param [out] offset -- Offset of the record line, may be nullptr
+     * \return Document or nullptr at the end of the text or on error
+     */
+    json_value* next(size_t* offset = nullptr);
+
+    /**
+     * Parse all the records and pass them to the handler. Document is
+     * valid only during the handler call. Chunks are parsed by the
+     * thread pool of the stream, which is kept for the next calls with
+     * the same number of threads. The unordered pass keeps one chunk per
+     * thread in memory. The ordered pass parses the chunks by rounds of
+     * two per thread, which are passed to the handler as they are
+     * ready. Exception of the handler stops the pass and is thrown again.
+     *
+     * \param [in] handler -- Record handler
+     * \param [in] threads -- Number of threads, 0 for the number of processors
+     * \param [in] order   -- Order of the handler calls
+     * \return Return result of operation. false if there is bad record.
+     */
+    bool for_each(const handler_t& handler, unsigned threads = 0, order_t order = o_ordered);
+
+    /**
+     * Return state of the stream. If true is return, bad record is found.
+     */
+    bool bad() const { return m_badbit; }
+
+    /**
+     * Offset of the line of the bad record in the text, valid if bad()
+     */
+    size_t bad_offset() const { return m_bad_offset; }
+
+  };
+
+}
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,37 @@
+/**
+ * \file json_string.h
+ */
+
+#ifndef JSON_STRING_H
+#define JSON_STRING_H
+
+#include <string>
+#include <cstddef>
+
+namespace litejson
+{
+
+  /**
+   * Check that the text is valid UTF-8: no overlong forms, no surrogates,
+   * no code points above U+10FFFF. ASCII is checked 16 bytes at a time.
+   *
+   * \param [in] p    -- Text
+   * \param [in] size -- Size of the text in bytes
+   * \return true if text is valid UTF-8
+   */
+  bool validate_utf8(const char* p, size_t size);
+
+  /**
+   * Decode JSON string body into UTF-8. Plain parts of the string
+   * between escapes are validated and copied in bulk.
+   *
+   * \param [in] p    -- First character after the opening quote
+   * \param [in] end  -- End of the text
+   * \param [out] out -- Decoded string
+   * \return Pointer after the closing quote or nullptr on error
+   */
+  const char* decode_string(const char* p, const char* end, std::string& out);
+
+}
+
+#endif // JSON_STRING_H
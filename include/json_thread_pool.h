@@ -0,0 +1,98 @@
+/**
+ * \file json_thread_pool.h
+ */
+
+#ifndef JSON_THREAD_POOL_H
+#define JSON_THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace litejson
+{
+
+  /**
+   * Work-stealing thread pool. Tasks of run() are split into equal
+   * ranges, one per worker. Worker takes tasks from the front of its
+   * range, and when it is empty, steals from the back of the others.
+   */
+  class json_thread_pool
+  {
+
+  public:
+
+    typedef std::function<void(size_t task, unsigned worker)> task_t;
+
+  private:
+
+    /**
+     * Tasks of the worker
+     */
+    struct alignas(64) range
+    {
+      std::mutex lock;
+      size_t begin;                                     //!< Next own task
+      size_t end;                                       //!< End of the tasks, stolen from here
+    };
+
+    unsigned m_size;                                    //!< Number of workers, including the caller of run()
+    std::unique_ptr<range[]> m_ranges;                  //!< Tasks of every worker
+    std::vector<std::thread> m_threads;                 //!< Workers except the caller
+
+    std::mutex m_mutex;
+    std::condition_variable m_start;                    //!< New tasks or stop
+    std::condition_variable m_done;                     //!< All the workers are idle
+    const task_t* m_task;                               //!< Current task function
+    size_t m_generation;                                //!< Number of run() calls
+    unsigned m_active;                                  //!< Number of busy threads
+    bool m_stop;                                        //!< Threads must exit
+    std::exception_ptr m_error;                         //!< First exception of the tasks
+
+    void thread_main(unsigned worker);
+    void work(unsigned worker);
+    bool pop(unsigned worker, size_t& task);
+    bool steal(unsigned worker, size_t& task);
+
+  public:
+
+    /**
+     * Start the threads
+     *
+     * \param [in] threads -- Number of workers, 0 for the number of processors
+     */
+    explicit json_thread_pool(unsigned threads = 0);
+
+    /**
+     * Stop the threads
+     */
+    ~json_thread_pool();
+
+    json_thread_pool(const json_thread_pool&) = delete;
+    json_thread_pool& operator=(const json_thread_pool&) = delete;
+
+    /**
+     * Number of workers
+     */
+    unsigned size() const { return m_size; }
+
+    /**
+     * Call task for every number in [0, count) and wait for the end.
+     * The calling thread is worker 0. First exception of the tasks is
+     * thrown again after all tasks are finished.
+     *
+     * \param [in] count -- Number of tasks
+     * \param [in] task  -- Task function
+     */
+    void run(size_t count, const task_t& task);
+
+  };
+
+}
+
+#endif // JSON_THREAD_POOL_H
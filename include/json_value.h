@@ -6,22 +6,68 @@
 #define JSON_VALUE_H
 
 #include <string>
-#include <vector>
-#include <map>
+#include <string_view>
 #include <ostream>
-#include <memory>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "json_arena.h"
 
 namespace litejson
 {
 
+  struct json_member;
+  class json_lazy;
+  class json_writer;
+  struct json_stats;
+  class json_cache;
+
+  /**
+   * Range of the array entries or object members, usable with range-for
+   * and standard algorithms. Iterators are plain pointers into the
+   * storage of the value, valid while it is not changed.
+   */
+  template<class T>
+  class json_range
+  {
+
+  private:
+
+    T* m_begin;
+    T* m_end;
+
+  public:
+
+    json_range(T* begin, T* end) : m_begin(begin), m_end(end) {}
+
+    T* begin() const { return m_begin; }
+    T* end() const { return m_end; }
+    size_t size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+    T& operator[](size_t index) const { return m_begin[index]; }
+
+  };
+
   /**
    * JSON Value class
-   * JSON parser unit. Parse single JSON file and manage it.
+   * Single node of the JSON tree. The value is a 16 bytes tagged union:
+   * null, boolean, number and strings up to 14 bytes are stored inline,
+   * longer strings, arrays and objects keep the pointer to their storage.
+   * Storage is either owned by the value (heap) or by the arena of the
+   * document, which releases it at once. Arrays and objects of the lazy
+   * document are parsed on the first access, so such document must not
+   * be read from several threads at once.
    */
   class json_value
   {
 
-  protected:
+  public:
 
     /**
      * Value type
@@ -34,121 +80,893 @@ namespace litejson
       t_string,                                   //!< The value is string
       t_array,                                    //!< The value is value array
       t_object                                    //!< The value is object
-    } m_value_type;
+    };
+
+    static const size_t short_string_max = 14;    //!< Longest string stored inline
+    static const size_t index_min = 16;           //!< Objects with so many entries get the hash index
+
+  protected:
+
+    /**
+     * Flags stored with the type
+     */
+    enum
+    {
+      f_type_mask = 0x0F,                         //!< Bits of json_value_type_t
+      f_owned = 0x10,                             //!< Storage is deleted by the value
+      f_short = 0x20,                             //!< String is stored inline
+      f_indexed = 0x40,                           //!< Object storage is followed by the hash index
+      f_lazy = 0x80                               //!< Array or object is not parsed yet
+    };
+
+    /**
+     * Representation of the number, stored in the aux byte
+     */
+    enum
+    {
+      n_double,                                   //!< Number is double
+      n_int64,                                    //!< Number is signed integer
+      n_uint64                                    //!< Number is unsigned integer above INT64_MAX
+    };
+
+    // All variants start with the same header, so type may be read through any of them
+
+    struct header_t
+    {
+      uint8_t type;                               //!< Type and flags
+      uint8_t aux;                                //!< Variant specific byte
+    };
+
+    struct scalar_t
+    {
+      uint8_t type;
+      uint8_t aux;                                //!< Representation of the number
+      uint16_t reserved;
+      uint32_t reserved2;
+      union
+      {
+        bool boolean;
+        double number;
+        int64_t int64;
+        uint64_t uint64;
+      };
+    };
+
+    struct string_t
+    {
+      uint8_t type;
+      uint8_t aux;
+      uint16_t reserved;
+      uint32_t size;                              //!< Length of the string
+      const char* chars;                          //!< Characters, zero terminated unless they are in the input text
+    };
+
+    struct short_string_t
+    {
+      uint8_t type;
+      uint8_t size;                               //!< Length of the string
+      char chars[short_string_max];               //!< Characters, not terminated
+    };
+
+    struct array_t
+    {
+      uint8_t type;
+      uint8_t capacity;                           //!< log2 of the capacity, 0 if capacity equals size
+      uint16_t reserved;
+      uint32_t size;                              //!< Number of entries
+      json_value* items;                          //!< Entries
+    };
+
+    struct object_t
+    {
+      uint8_t type;
+      uint8_t capacity;                           //!< log2 of the capacity, 0 if capacity equals size
+      uint16_t reserved;
+      uint32_t size;                              //!< Number of entries
+      json_member* members;                       //!< Entries in insertion order
+    };
+
+    struct lazy_t
+    {
+      uint8_t type;
+      uint8_t aux;
+      uint16_t reserved;
+      uint32_t container;                         //!< Number of the container in the lazy document
+      json_lazy* document;                        //!< Document which parses the container on access
+    };
+
+    /**
+     * Slot of the object hash index. Open addressing with linear probing,
+     * the index follows the members in the same block.
+     */
+    struct index_slot
+    {
+      uint32_t hash;                              //!< Cached hash of the key
+      uint32_t position;                          //!< Position of the member plus one, 0 if slot is empty
+    };
+
+    union
+    {
+      header_t m_header;
+      scalar_t m_scalar;
+      string_t m_string;
+      short_string_t m_short;
+      array_t m_array;
+      object_t m_object;
+      lazy_t m_lazy;
+    };
+
+    friend class json_lazy;
+    friend class json_writer;
+    friend struct json_stats;
+    friend class json_cache;
+
+    /**
+     * Parse array or object of the lazy document. Parsed value replaces
+     * the lazy one in place, so it is done once.
+     */
+    void expand() const;
+
+    /**
+     * Set value to null without releasing storage
+     */
+    void reset() { m_scalar.type = t_null; m_scalar.aux = 0; m_scalar.reserved = 0; m_scalar.reserved2 = 0; m_string.chars = nullptr; }
+
+    /**
+     * Release owned storage and set value to null
+     */
+    void release();
+
+    /**
+     * Make deep copy of other value. Storage of the copy is owned.
+     */
+    void copy_from(const json_value& other);
+
+    /**
+     * Set string value. Short string is stored inline, long one
+     * is copied into the arena or into the heap if arena is nullptr.
+     */
+    void set_string(const char* str, size_t len, json_arena* arena);
+
+    /**
+     * Move the array or object into owned storage for at least count entries
+     */
+    void grow(size_t count);
+
+    /**
+     * Make the value an array (if needed) with room for one more entry
+     *
+     * \return Storage of the new entry, not constructed
+     */
+    json_value* reserve_item();
 
-    typedef std::vector<json_value*> value_array_t;
-    typedef std::map<std::string, json_value*> value_object_t;
+    /**
+     * Make the value an object (if needed) with room for one more entry
+     *
+     * \return Storage of the new entry, not constructed
+     */
+    json_member* reserve_member();
+
+    /**
+     * Add the constructed member after reserve_member()
+     */
+    void commit_member(std::string_view key);
+
+    /**
+     * Capacity of the array or object storage
+     */
+    size_t capacity() const { return m_array.capacity == 0 ? m_array.size : size_t(1) << m_array.capacity; }
+
+    /**
+     * Number of the hash index slots for the object capacity
+     */
+    static size_t index_size(size_t capacity)
+    {
+      size_t n = 4;
+
+      while (n < 2 * capacity)
+        n <<= 1;
+      return n;
+    }
+
+    /**
+     * Hash index of the object. Valid only with f_indexed.
+     */
+    index_slot* index() const;
+
+    /**
+     * Allocate storage for the object members and the hash index if
+     * it is needed for such capacity
+     */
+    static json_member* allocate_members(size_t capacity, json_arena* arena);
+
+    /**
+     * Clear and fill hash index with all the members. Later duplicate wins.
+     */
+    void build_index();
+
+    /**
+     * Put member into the hash index, replacing the slot of the same key
+     */
+    void index_insert(uint32_t hash, uint32_t position);
+
+    /**
+     * Set number value
+     */
+    void set_number(double d) { reset(); m_scalar.type = t_number; m_scalar.aux = n_double; m_scalar.number = d; }
+    void set_number(int64_t i) { reset(); m_scalar.type = t_number; m_scalar.aux = n_int64; m_scalar.int64 = i; }
+    void set_number(uint64_t u)
+    {
+      if (u <= uint64_t(INT64_MAX))
+        set_number(int64_t(u));
+      else
+        {
+          reset();
+          m_scalar.type = t_number;
+          m_scalar.aux = n_uint64;
+          m_scalar.uint64 = u;
+        }
+    }
 
-    std::shared_ptr<void> m_data_smartptr;
+    /**
+     * Throw exception about wrong type of the value
+     */
+    [[noreturn]] static void type_error(const char* what);
 
   public:
 
     /**
      * Default constructor
      */
-    json_value();
+    json_value() { reset(); }
 
     /**
      * Destructor
      */
-    virtual ~json_value();
+    ~json_value() { if (m_header.type & f_owned) release(); }
 
     /**
-     * Copy constructor from another JSON Value object.
-     * This is not exactly the copying. It's just pointer copy.
-     * 
+     * Copy constructor from another JSON Value object. Whole
+     * subtree is copied into the heap.
+     *
      * \param [in] other -- JSON Value to copy from
-     * 
-     * \note Old content of the JSON Value object will be lost.
      */
     json_value(const json_value& other);
 
+    /**
+     * Move constructor. Other value becomes null.
+     *
+     * \param [in] other -- JSON Value to move from
+     */
+    json_value(json_value&& other) noexcept : m_string(other.m_string) { other.reset(); }
+
     /**
      * Construct a new json value from number. Set the type of json value as t_number
-     * 
-     * \param [in] f -- Float or int value
+     *
+     * \param [in] f -- Float value
+     */
+    json_value(float f) { set_number(double(f)); }
+    json_value(double d) { set_number(d); }
+
+    /**
+     * Construct a new json value from integer. Integer is stored exactly.
+     *
+     * \param [in] i -- Integer value
      */
-    json_value(float f);
+    json_value(int i) { set_number(int64_t(i)); }
+    json_value(long i) { set_number(int64_t(i)); }
+    json_value(long long i) { set_number(int64_t(i)); }
+    json_value(unsigned int u) { set_number(uint64_t(u)); }
+    json_value(unsigned long u) { set_number(uint64_t(u)); }
+    json_value(unsigned long long u) { set_number(uint64_t(u)); }
 
     /**
      * Construct a new json value from boolean. Set the type of json value as t_boolean
-     * 
+     *
      * \param [in] b -- Boolean value
      */
-    json_value(bool b);
+    json_value(bool b) { reset(); m_scalar.type = t_boolean; m_scalar.boolean = b; }
 
     /**
      * Construct a new json value from string. Set the type of json value as t_string
-     * 
+     *
+     * \param [in] str -- String value
+     */
+    json_value(const std::string& str) { set_string(str.data(), str.size(), nullptr); }
+
+    /**
+     * Construct a new json value from zero terminated string
+     *
+     * \param [in] str -- String value
+     */
+    json_value(const char* str) { set_string(str, std::char_traits<char>::length(str), nullptr); }
+
+    /**
+     * Construct a new json value from string. Long string is copied
+     * into the arena and is released with it.
+     *
+     * \param [in] str   -- String value
+     * \param [in] arena -- Arena for the characters
+     */
+    json_value(std::string_view str, json_arena& arena) { set_string(str.data(), str.size(), &arena); }
+
+    /**
+     * Tag of the constructor which does not copy the characters
+     */
+    struct view_t {};
+    static constexpr view_t view{};
+
+    /**
+     * Construct a new json value which refers to the characters instead
+     * of copying them, e.g. to the input text of the parser. Short string
+     * is still stored inline. The characters must live as long as the
+     * value, copies of the value own their characters.
+     *
+     * \param [in] str -- String value
+     */
+    json_value(std::string_view str, view_t)
+    {
+      if (str.size() <= short_string_max)
+        set_string(str.data(), str.size(), nullptr);
+      else
+        {
+          reset();
+          m_string.type = t_string;
+          m_string.size = str.size();
+          m_string.chars = str.data();
+        }
+    }
+
+    /**
+     * Construct a new json value from string. Long string is copied into the heap.
+     *
      * \param [in] str -- String value
      */
-    json_value(const std::string& str);
+    json_value(std::string_view str) { set_string(str.data(), str.size(), nullptr); }
+
+    /**
+     * Release heap storage which was put into the tree of arena nodes,
+     * e.g. by add_array_entry() on the loaded array or by assignment of
+     * a long string to the loaded member. Arena nodes are never
+     * destroyed, so the owner of the arena calls it before clearing the
+     * arena. Nothing is freed for the tree which was not changed.
+     * Unparsed lazy containers are skipped.
+     */
+    void release_owned();
+
+    /**
+     * Convert value to the empty array. Old content of the value will be lost.
+     */
+    void make_array();
+
+    /**
+     * Convert value to the empty object. Old content of the value will be lost.
+     */
+    void make_object();
 
     /**
      * Convert value to the array (if needed) and add new entry
-     * 
-     * \param [in] val -- New entry
+     *
+     * \param [in] val -- New entry. It must be created by new, it is moved
+     *                    into the array and deleted.
      */
     void add_array_entry(json_value* val);
 
     /**
-     * Convert value to the object (if needed) and add new entry
-     * 
+     * Convert value to the array (if needed) and move new entry into it
+     *
+     * \param [in] val -- New entry, becomes null
+     * \return Entry in the array
+     */
+    json_value& add_array_entry(json_value&& val) { return emplace_array_entry(std::move(val)); }
+
+    /**
+     * Convert value to the array (if needed) and construct new entry in place
+     *
+     * \param [in] args -- Arguments of the json_value constructor, must not refer to the entries of the array
+     * \return Entry in the array
+     */
+    template<class... Args>
+    json_value& emplace_array_entry(Args&&... args)
+    {
+      json_value* entry = reserve_item();
+
+      new (entry) json_value(std::forward<Args>(args)...);
+      m_array.size++;
+      return *entry;
+    }
+
+    /**
+     * Convert value to the object (if needed) and add new entry.
+     * Entry with the same key is replaced.
+     *
      * \param [in] key -- New entry key
-     * \param [in] val -- New entry value
+     * \param [in] val -- New entry value. It must be created by new, it is moved
+     *                    into the object and deleted.
+     */
+    void add_object_entry(std::string_view key, json_value* val);
+
+    /**
+     * Convert value to the object (if needed) and move new entry into it.
+     * Entry with the same key is replaced.
+     *
+     * \param [in] key -- New entry key, short key is stored inline
+     * \param [in] val -- New entry value, becomes null
+     * \return Entry value in the object
+     */
+    json_value& add_object_entry(std::string_view key, json_value&& val) { return emplace_object_entry(key, std::move(val)); }
+
+    /**
+     * Convert value to the object (if needed) and move new entry into it.
+     * The key is moved too, so long key is not copied. Entry with the
+     * same key is replaced. Throw std::runtime_error if key is not a string.
+     *
+     * \param [in] member -- New entry key and value, both become null
+     * \return Entry value in the object
+     */
+    json_value& add_object_entry(json_member&& member);
+
+    /**
+     * Convert value to the object (if needed) and construct new entry
+     * in place. Entry with the same key is replaced.
+     *
+     * \param [in] key  -- New entry key
+     * \param [in] args -- Arguments of the json_value constructor
+     * \return Entry value in the object
+     */
+    template<class... Args>
+    json_value& emplace_object_entry(std::string_view key, Args&&... args);
+
+    /**
+     * Reserve storage of the array or object, so the entries up to
+     * the capacity are added without reallocation. Throw
+     * std::runtime_error if value is not an array or object.
+     *
+     * \param [in] count -- Number of entries
+     */
+    void reserve(size_t count);
+
+    /**
+     * Replace value with the array. Entries are moved into the storage
+     * allocated from the arena. Used by the parsers.
+     *
+     * \param [in] items -- Entries
+     * \param [in] count -- Number of entries
+     * \param [in] arena -- Arena of the document
+     */
+    void assign_array(json_value* items, size_t count, json_arena& arena);
+
+    /**
+     * Replace value with the object. Entries are moved into the storage
+     * allocated from the arena. Used by the parsers.
+     *
+     * \param [in] pairs -- Keys and values, one after another
+     * \param [in] count -- Number of entries (pairs)
+     * \param [in] arena -- Arena of the document
      */
-    void add_object_entry(const std::string& key, json_value* val);
+    void assign_object(json_value* pairs, size_t count, json_arena& arena);
 
     /**
-     * Assignment operator. This is not exactly the copying.
-     * It's just pointer copy.
-     * 
+     * Assignment operator. Whole subtree is copied into the heap.
+     *
      * \note Old content of the JSON Value object will be lost.
      */
     json_value& operator=(const json_value& other);
 
+    /**
+     * Move assignment. Other value becomes null.
+     *
+     * \note Old content of the JSON Value object will be lost.
+     */
+    json_value& operator=(json_value&& other) noexcept;
+
+    /**
+     * Type of the value
+     */
+    json_value_type_t type() const { return json_value_type_t(m_header.type & f_type_mask); }
+
     /**
      * Is value null
      */
-    virtual bool is_null() const;
+    bool is_null() const { return type() == t_null; }
 
     /**
      * Is value string
      */
-    virtual bool is_string() const;
+    bool is_string() const { return type() == t_string; }
 
     /**
      * Is value boolean
      */
-    virtual bool is_boolean() const;
+    bool is_boolean() const { return type() == t_boolean; }
 
     /**
      * Is value number
      */
-    virtual bool is_number() const;
+    bool is_number() const { return type() == t_number; }
 
     /**
      * Is value object
      */
-    virtual bool is_object() const;
+    bool is_object() const { return type() == t_object; }
 
     /**
      * Is value value array
      */
-    virtual bool is_array() const;
+    bool is_array() const { return type() == t_array; }
+
+    /**
+     * String value without copy. Strings loaded with zero copy refer to
+     * the input text. Throw std::runtime_error if value is not a string.
+     */
+    std::string_view as_string_view() const
+    {
+      if (!is_string())
+        type_error("is not a string");
+      if (m_header.type & f_short)
+        return std::string_view(m_short.chars, m_short.size);
+      return std::string_view(m_string.chars, m_string.size);
+    }
+
+    /**
+     * Copy of the string value. Throw std::runtime_error if value is not a string.
+     */
+    std::string as_string() const { return std::string(as_string_view()); }
+
+    /**
+     * Is value number stored as exact integer
+     */
+    bool is_integer() const { return is_number() && m_scalar.aux != n_double; }
+
+    /**
+     * Number value as signed 64 bit integer. Fractional number is rounded.
+     * Throw std::runtime_error if value is not a number or does not fit.
+     */
+    int64_t as_int64() const
+    {
+      if (!is_number())
+        type_error("is not a number");
+      if (m_scalar.aux == n_int64)
+        return m_scalar.int64;
+      if (m_scalar.aux == n_uint64 || !(m_scalar.number >= -9223372036854775808.0 && m_scalar.number < 9223372036854775808.0))
+        type_error("is out of range");
+      return int64_t(std::nearbyint(m_scalar.number));
+    }
+
+    /**
+     * Number value as unsigned 64 bit integer. Fractional number is rounded.
+     * Throw std::runtime_error if value is not a number or does not fit.
+     */
+    uint64_t as_uint64() const
+    {
+      if (!is_number())
+        type_error("is not a number");
+      if (m_scalar.aux == n_uint64)
+        return m_scalar.uint64;
+      if (m_scalar.aux == n_int64 && m_scalar.int64 >= 0)
+        return uint64_t(m_scalar.int64);
+      if (m_scalar.aux == n_int64 || !(m_scalar.number >= -0.5 && m_scalar.number < 18446744073709551616.0))
+        type_error("is out of range");
+      return uint64_t(std::nearbyint(m_scalar.number));
+    }
+
+    /**
+     * Number value as double. Large integers are rounded to the nearest double.
+     * Throw std::runtime_error if value is not a number.
+     */
+    double as_double() const
+    {
+      if (!is_number())
+        type_error("is not a number");
+      if (m_scalar.aux == n_int64)
+        return double(m_scalar.int64);
+      if (m_scalar.aux == n_uint64)
+        return double(m_scalar.uint64);
+      return m_scalar.number;
+    }
+
+    /**
+     * Number value rounded to integer. Throw std::runtime_error if value
+     * is not a number or does not fit int.
+     */
+    int as_integer() const
+    {
+      int64_t i = as_int64();
+
+      if (i < INT_MIN || i > INT_MAX)
+        type_error("is out of range");
+      return int(i);
+    }
+
+    /**
+     * Number value. Throw std::runtime_error if value is not a number.
+     */
+    float as_float() const { return float(as_double()); }
+
+    /**
+     * Boolean value. Throw std::runtime_error if value is not a boolean.
+     */
+    bool as_boolean() const
+    {
+      if (!is_boolean())
+        type_error("is not a boolean");
+      return m_scalar.boolean;
+    }
+
+    /**
+     * Value without exceptions. Integers are range checked, fractional
+     * numbers are not converted to integers.
+     *
+     * \param [out] val -- Value, unchanged on failure
+     * \return false if value has other type or does not fit
+     */
+    bool get(bool& val) const noexcept
+    {
+      if (!is_boolean())
+        return false;
+      val = m_scalar.boolean;
+      return true;
+    }
 
-    // TODO : Should i throw an exception if value is not same as extract function
-    virtual const std::string& as_string();
-    virtual int as_integer();
-    virtual float as_float();
-    virtual bool as_boolean();
-    virtual json_value* as_array(int index);
-    virtual json_value* as_object(const std::string& key);
+    bool get(int64_t& val) const noexcept
+    {
+      if (!is_number() || m_scalar.aux != n_int64)
+        return false;
+      val = m_scalar.int64;
+      return true;
+    }
 
-    virtual void print(std::ostream& stream);
+    bool get(uint64_t& val) const noexcept
+    {
+      if (!is_number() || m_scalar.aux == n_double || (m_scalar.aux == n_int64 && m_scalar.int64 < 0))
+        return false;
+      val = m_scalar.uint64;                            // Same bits for non-negative int64
+      return true;
+    }
+
+    bool get(double& val) const noexcept
+    {
+      if (!is_number())
+        return false;
+      val = as_double();
+      return true;
+    }
+
+    bool get(std::string_view& val) const noexcept
+    {
+      if (!is_string())
+        return false;
+      val = as_string_view();
+      return true;
+    }
+
+    /**
+     * Number of the array entries or object members, 0 for other values
+     */
+    size_t size() const
+    {
+      if (type() != t_array && type() != t_object)
+        return 0;
+      if (m_header.type & f_lazy)
+        expand();
+      return m_array.size;
+    }
+
+    /**
+     * Entries of the array, empty range for other values
+     */
+    json_range<const json_value> items() const
+    {
+      if (!is_array())
+        return json_range<const json_value>(nullptr, nullptr);
+      if (m_header.type & f_lazy)
+        expand();
+      return json_range<const json_value>(m_array.items, m_array.items + m_array.size);
+    }
+
+    json_range<json_value> items()
+    {
+      json_range<const json_value> r = static_cast<const json_value*>(this)->items();
+
+      return json_range<json_value>(const_cast<json_value*>(r.begin()), const_cast<json_value*>(r.end()));
+    }
+
+    /**
+     * Members of the object in insertion order, empty range for other
+     * values. Duplicate keys are all listed.
+     */
+    json_range<const json_member> members() const;
+    json_range<json_member> members();
+
+    /**
+     * Entries of the array for range-for, see items()
+     */
+    const json_value* begin() const { return items().begin(); }
+    const json_value* end() const { return items().end(); }
+    json_value* begin() { return items().begin(); }
+    json_value* end() { return items().end(); }
+
+    /**
+     * Array entry. Throw std::runtime_error if value is not an array.
+     *
+     * \param [in] index -- Index of the entry
+     * \return Entry or nullptr if index is out of range
+     */
+    const json_value* as_array(int index) const
+    {
+      if (!is_array())
+        type_error("is not an array");
+      if (m_header.type & f_lazy)
+        expand();
+      if (index < 0 || uint32_t(index) >= m_array.size)
+        return nullptr;
+      return m_array.items + index;
+    }
+
+    json_value* as_array(int index)
+    {
+      return const_cast<json_value*>(static_cast<const json_value*>(this)->as_array(index));
+    }
+
+    /**
+     * Object entry. Throw std::runtime_error if value is not an object.
+     * Small objects are searched linearly, large ones through the hash index.
+     *
+     * \param [in] key -- Key of the entry
+     * \return Entry or nullptr if there is no such key
+     */
+    const json_value* as_object(std::string_view key) const
+    {
+      if (!is_object())
+        type_error("is not an object");
+      if (m_header.type & f_lazy)
+        expand();
+      if (m_header.type & f_indexed)
+        return find_member(key, hash(key));
+      return find_member(key);
+    }
+
+    json_value* as_object(std::string_view key)
+    {
+      return const_cast<json_value*>(static_cast<const json_value*>(this)->as_object(key));
+    }
+
+    /**
+     * Object entry with the precomputed hash of the key.
+     * Throw std::runtime_error if value is not an object.
+     *
+     * \param [in] key      -- Key of the entry
+     * \param [in] key_hash -- hash(key)
+     * \return Entry or nullptr if there is no such key
+     */
+    const json_value* as_object(std::string_view key, uint32_t key_hash) const
+    {
+      if (!is_object())
+        type_error("is not an object");
+      if (m_header.type & f_lazy)
+        expand();
+      if (m_header.type & f_indexed)
+        return find_member(key, key_hash);
+      return find_member(key);
+    }
+
+    json_value* as_object(std::string_view key, uint32_t key_hash)
+    {
+      return const_cast<json_value*>(static_cast<const json_value*>(this)->as_object(key, key_hash));
+    }
+
+    /**
+     * Value referred by the JSON Pointer (RFC 6901). Throw std::runtime_error
+     * if the pointer is not valid. Use json_pointer for the repeated lookups.
+     *
+     * \param [in] pointer -- JSON Pointer, e.g. "/servers/3/limits/rps"
+     * \return Value or nullptr if there is no such value
+     */
+    const json_value* at_pointer(std::string_view pointer) const;
+
+    json_value* at_pointer(std::string_view pointer)
+    {
+      return const_cast<json_value*>(static_cast<const json_value*>(this)->at_pointer(pointer));
+    }
+
+    /**
+     * Hash of the object key, as used by the object index
+     *
+     * \param [in] key -- Key
+     */
+    static uint32_t hash(std::string_view key)
+    {
+      const char* p = key.data();
+      size_t n = key.size();
+      uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+      uint64_t w;
+
+      while (n >= 8)
+        {
+          std::memcpy(&w, p, 8);
+          h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+          h ^= h >> 32;
+          p += 8;
+          n -= 8;
+        }
+      if (n != 0)
+        {
+          w = 0;
+          std::memcpy(&w, p, n);
+          h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        }
+
+      h ^= h >> 29;
+      h *= 0xC4CEB9FE1A85EC53ull;
+      h ^= h >> 32;
+      return uint32_t(h);
+    }
+
+    void print(std::ostream& stream) const;
+
+  protected:
+
+    /**
+     * Linear search of the member, last duplicate wins
+     */
+    json_value* find_member(std::string_view key) const;
+
+    /**
+     * Search of the member through the hash index
+     */
+    json_value* find_member(std::string_view key, uint32_t key_hash) const;
 
   };
 
+  /**
+   * Entry of the JSON object
+   */
+  struct json_member
+  {
+    json_value name;                              //!< Key, always a string
+    json_value value;                             //!< Value
+  };
+
+  static_assert(sizeof(json_value) == 16, "json_value must fit 16 bytes");
+
+  inline json_range<const json_member> json_value::members() const
+  {
+    if (!is_object())
+      return json_range<const json_member>(nullptr, nullptr);
+    if (m_header.type & f_lazy)
+      expand();
+    return json_range<const json_member>(m_object.members, m_object.members + m_object.size);
+  }
+
+  inline json_range<json_member> json_value::members()
+  {
+    json_range<const json_member> r = static_cast<const json_value*>(this)->members();
+
+    return json_range<json_member>(const_cast<json_member*>(r.begin()), const_cast<json_member*>(r.end()));
+  }
+
+  inline json_value::index_slot* json_value::index() const
+  {
+    return reinterpret_cast<index_slot*>(m_object.members + capacity());
+  }
+
+  template<class... Args>
+  json_value& json_value::emplace_object_entry(std::string_view key, Args&&... args)
+  {
+    json_value val(std::forward<Args>(args)...);        // Nothing leaks if allocation of the key throws
+    json_value* old = type() == t_object ? as_object(key) : nullptr;
+    json_member* entry;
+
+    if (old != nullptr)
+      return *old = std::move(val);
+
+    entry = reserve_member();
+    new (&entry->name) json_value(key);
+    new (&entry->value) json_value(std::move(val));
+    commit_member(key);
+    return entry->value;
+  }
+
 }
 
 #endif // JSON_VALUE_H
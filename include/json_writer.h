@@ -0,0 +1,180 @@
+/**
+ * \file json_writer.h
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "json_value.h"
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <vector>
+
+namespace litejson
+{
+
+  /**
+   * JSON text writer. The text is appended into the buffer, which is
+   * passed to the sink when it grows over sink_threshold after any
+   * written value, key or bracket. The rest of the text is passed by
+   * flush(), the destructor does not call the sink. Strings are
+   * escaped, numbers are written in the shortest form which reads back
+   * to the same value (float values to the same float). Infinity and NaN are written as null.
+   */
+  class json_writer
+  {
+
+  public:
+
+    typedef std::function<void(std::string_view)> sink_t;
+
+    static const size_t sink_threshold = 64 * 1024;     //!< Buffer size which is passed to the sink
+
+  private:
+
+    std::string m_buffer;                               //!< Text which is not given to the sink yet
+    sink_t m_sink;                                      //!< Receiver of the text or empty
+    int m_indent;                                       //!< Spaces per level, 0 for compact text
+    std::vector<uint32_t> m_entries;                    //!< Entries of every open array and object
+    bool m_after_key;                                   //!< Member name is written, value is not
+
+    /**
+     * Array or object which is being written by write_value()
+     */
+    struct frame
+    {
+      const json_value* container;                      //!< Array or object
+      size_t next;                                      //!< Index of the next entry
+    };
+
+    std::vector<frame> m_frames;                        //!< Open arrays and objects, innermost last
+
+    /**
+     * Write the value with its subtree. Nested arrays and objects are
+     * kept on the frame stack, so the writer does not recurse.
+     */
+    void write_value(const json_value& val, int depth);
+    void write_number(const json_value& val);
+    void write_string(std::string_view str);
+    void write_newline(int depth);
+    void write_integer(int64_t i);
+    void write_integer(uint64_t u);
+    void write_double(double d);
+    void write_float(float f);
+
+    /**
+     * Separator and indentation before the next value of the open array or object
+     */
+    void begin_value();
+
+    /**
+     * Closing bracket of the open array or object
+     */
+    void end_container(char bracket);
+
+    /**
+     * Pass the buffer to the sink if it is over sink_threshold
+     */
+    void flush_full()
+    {
+      if (m_sink && m_buffer.size() >= sink_threshold)
+        flush();
+    }
+
+  public:
+
+    /**
+     * Make writer into the internal buffer
+     *
+     * \param [in] indent -- Spaces per nesting level, 0 for compact text
+     */
+    explicit json_writer(int indent = 0);
+
+    /**
+     * Make writer into the sink
+     *
+     * \param [in] sink   -- Receiver of the text
+     * \param [in] indent -- Spaces per nesting level, 0 for compact text
+     */
+    json_writer(sink_t sink, int indent = 0);
+
+    /**
+     * Destructor. Text which is not passed to the sink by flush() is lost.
+     */
+    ~json_writer();
+
+    json_writer(const json_writer&) = delete;
+    json_writer& operator=(const json_writer&) = delete;
+
+    /**
+     * Append the value with all its subtree
+     *
+     * \param [in] val -- Value to write
+     */
+    void write(const json_value& val);
+
+    /**
+     * Streaming output: open array or object, then write its entries
+     * by value() or write() (and key() before every object member)
+     * and close it. No tree is needed.
+     */
+    void begin_array();
+    void end_array();
+    void begin_object();
+    void end_object();
+
+    /**
+     * Append name of the next member of the open object
+     *
+     * \param [in] name -- Member name
+     */
+    void key(std::string_view name);
+
+    /**
+     * Append scalar value
+     *
+     * \param [in] val -- Value
+     */
+    void value(bool val);
+    void value(int val) { value((long long)val); }
+    void value(long val) { value((long long)val); }
+    void value(long long val);
+    void value(unsigned int val) { value((unsigned long long)val); }
+    void value(unsigned long val) { value((unsigned long long)val); }
+    void value(unsigned long long val);
+    void value(float val);
+    void value(double val);
+    void value(std::string_view val);
+    void value(const char* val) { value(std::string_view(val)); }
+    void null_value();
+
+    /**
+     * Pass the buffered text to the sink. Does nothing without sink.
+     */
+    void flush();
+
+    /**
+     * Text which is not passed to the sink
+     */
+    const std::string& str() const { return m_buffer; }
+
+    /**
+     * Drop the buffered text
+     */
+    void clear() { m_buffer.clear(); }
+
+    /**
+     * Write the value into the string
+     *
+     * \param [in] val    -- Value to write
+     * \param [in] indent -- Spaces per nesting level, 0 for compact text
+     */
+    static std::string to_string(const json_value& val, int indent = 0);
+
+  };
+
+}
+
+#endif // JSON_WRITER_H
@@ -9,8 +9,17 @@
 #include <ostream>
 #include <fstream>
 #include <vector>
+#include <memory>
+#include <string_view>
+#include <chrono>
+#include <cstddef>
 
 #include "json_value.h"
+#include "json_lazy.h"
+#include "json_key_table.h"
+#include "json_mapped_file.h"
+#include "json_stats.h"
+#include "json_thread_pool.h"
 
 namespace litejson
 {
@@ -21,10 +30,30 @@ namespace litejson
   class json_loader
   {
 
+  public:
+
+    /**
+     * Parsing mode
+     */
+    enum parse_mode_t
+    {
+      pm_single_pass,                                   //!< Fused lexer and parser, no token list
+      pm_two_pass,                                      //!< Token list by lexical(), then syntax()
+      pm_lazy,                                          //!< Arrays and objects are parsed on the first access
+      pm_parallel                                       //!< Entries of the root are parsed on several threads
+    };
+
+    static const size_t parallel_min = 1024 * 1024;     //!< Smaller text is parsed by single thread
+    static const size_t default_max_depth = 1024;       //!< Deeper text is an error
+
   private:
 
     json_value * m_root;                                //!< Root element of the JSON tree
+    std::vector<json_value*> m_documents;               //!< Roots of all the documents in the arena
+    json_arena m_arena;                                 //!< Memory of all nodes of the tree
     bool m_badbit;                                      //!< Bad flag for JSON parser
+    std::ostream* m_log;                                //!< Stream for the error messages
+    std::unique_ptr<std::ostream> m_null_log;           //!< Own stream which drops the messages of the worker loader
 
     struct token
     {
@@ -52,11 +81,20 @@ namespace litejson
     bool lexical(std::ifstream& stream, int* n);
 
     /**
-     * Make syntax analysis
+     * Make lexical analysis of the text in memory
+     *
+     * \param [in] begin  -- Begin of the text
+     * \param [in] end    -- End of the text
      * \param [out] n     -- Number of the line with error
      * \return Return result of operation. false on error.
      */
-    bool syntax(int* n);
+    bool lexical(const char* begin, const char* end, int* n);
+
+    /**
+     * Make syntax analysis. Errors are written to the log with their lines.
+     * \return Return result of operation. false on error.
+     */
+    bool syntax();
 
     /**
      * Make lexical analysis of single string
@@ -68,14 +106,230 @@ namespace litejson
     bool parse_string(std::string& str, int n);
 
     /**
-     * Parse token list and extract current node. This function
-     * must be called recursively to parse whole JSON file.
-     * 
-     * \param [in] node         -- Node, which receives children from JSON
+     * Parse token list and extract the value onto the value stack.
+     * Nested arrays and objects are kept on the frame stack, so the
+     * parser does not recurse.
+     *
      * \param [in, out] index   -- Index of the current token
-     * \return Extracted node or nullptr
+     * \return Return result of operation. false on error.
+     */
+    bool parse_node(int* index);
+
+    /**
+     * Extract object key and the following ``:'' from the token list
+     *
+     * \param [in, out] index   -- Index of the current token
+     * \return Return result of operation. false on error.
+     */
+    bool parse_key(int* index);
+
+    /**
+     * Extract value which is not an array or object from the token list
+     *
+     * \param [in, out] index   -- Index of the current token
+     * \return Return result of operation. false on error.
+     */
+    bool parse_scalar(int* index);
+
+    /**
+     * Unfinished array or object
+     */
+    struct frame
+    {
+      size_t base;                                      //!< Stack size before the first entry
+      bool object;                                      //!< Object or array
+    };
+
+    std::vector<json_value> m_stack;                    //!< Values of the unfinished arrays and objects
+    std::vector<frame> m_frames;                        //!< Unfinished arrays and objects, innermost last
+    size_t m_max_depth;                                 //!< Maximum nesting of arrays and objects
+
+    /**
+     * Open array or object
+     *
+     * \param [in] object -- Object or array
+     * \param [in] line   -- Line of the bracket
+     * \return Return result of operation. false if nesting is too deep.
+     */
+    bool push_frame(bool object, int line);
+
+    /**
+     * Close the innermost array or object
+     */
+    void pop_frame();
+
+    /**
+     * Replace values on top of the stack with the array made of them
+     *
+     * \param [in] base -- Stack size before the first entry
      */
-    json_value* parse_node(int* index);
+    void end_array(size_t base);
+
+    /**
+     * Replace keys and values on top of the stack with the object made of them
+     *
+     * \param [in] base -- Stack size before the first key
+     */
+    void end_object(size_t base);
+
+    /**
+     * Move the only value of the stack into the arena and make it the root
+     */
+    void set_root();
+
+    /**
+     * Position of the single pass parser inside the input text
+     */
+    struct cursor
+    {
+      const char* it;                                   //!< Current character
+      const char* end;                                  //!< End of the input text
+      int line;                                         //!< Current line number
+    };
+
+    std::string m_scratch;                              //!< Reusable buffer for string extraction
+
+    json_lazy m_lazy;                                   //!< Lazy document
+    json_mapped_file m_file;                            //!< Mapped text of the lazy document
+    std::string m_text;                                 //!< Copied text of the lazy document
+
+    bool m_zero_copy;                                   //!< Strings without escapes refer to the input text
+    std::shared_ptr<json_key_table> m_keys;             //!< Intern table of the long keys, may be nullptr
+    size_t m_keys_interned;                             //!< Keys of the tree taken from the table
+    size_t m_key_bytes_saved;                           //!< Bytes of the keys not copied thanks to the table
+    unsigned m_threads;                                 //!< Threads of the parallel mode, 0 for all processors
+    std::unique_ptr<json_thread_pool> m_pool;           //!< Threads of the parallel mode, kept between the loads
+    std::vector<std::unique_ptr<json_loader>> m_workers; //!< Arenas of the entries parsed by other threads
+
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    std::unique_ptr<json_stats> m_stats;                //!< Statistics of the last load, nullptr if off
+
+    /**
+     * Reset statistics before the load
+     *
+     * \param [in] bytes  -- Size of the text, if known
+     * \return Start time of the first phase or nothing if statistics are off
+     */
+    time_point start_stats(size_t bytes);
+
+    /**
+     * Add time of the phase to the statistics
+     *
+     * \param [in] phase  -- Finished phase
+     * \param [in] start  -- Start time of the phase
+     * \return Start time of the next phase
+     */
+    time_point lap(json_stats::phase_t phase, time_point start);
+
+    /**
+     * Count nodes and memory of the loaded tree
+     */
+    void finish_stats();
+
+    /**
+     * Parse text in memory in the given mode
+     *
+     * \param [in] begin  -- Begin of the text
+     * \param [in] end    -- End of the text
+     * \param [in] mode   -- Parsing mode
+     * \param [in] start  -- Start time of the parsing for the statistics
+     * \return Return result of operation. false on error.
+     */
+    bool parse(const char* begin, const char* end, parse_mode_t mode, time_point start);
+
+    /**
+     * Split text into the entries of the root array or object and parse
+     * them on several threads. Each worker keeps its nodes in its own
+     * arena, then the root is made of the entries. Small or bad text is
+     * parsed by parse_text(), so the tree and the errors are the same.
+     *
+     * \param [in] begin  -- Begin of the text
+     * \param [in] end    -- End of the text
+     * \return Return result of operation. false on error.
+     */
+    bool parse_parallel(const char* begin, const char* end);
+
+    /**
+     * Make lazy document of the text. The text must live as long as the tree.
+     *
+     * \param [in] begin  -- Begin of the text
+     * \param [in] end    -- End of the text
+     * \return Return result of operation. false on error.
+     */
+    bool open_lazy(const char* begin, const char* end);
+
+    /**
+     * Parse whole text in single pass without making token list
+     *
+     * \param [in] begin  -- Begin of the text
+     * \param [in] end    -- End of the text
+     * \return Return result of operation. false on error.
+     */
+    bool parse_text(const char* begin, const char* end);
+
+    /**
+     * Skip whitespaces and count lines
+     *
+     * \param [in, out] c -- Parser position
+     */
+    void skip_space(cursor& c);
+
+    /**
+     * Extract string directly from the text. Cursor must point to
+     * the opening quote.
+     *
+     * \param [in, out] c -- Parser position
+     * \param [out] str   -- Extracted string
+     * \return Return result of operation. false on error.
+     */
+    bool read_string(cursor& c, std::string& str);
+
+    /**
+     * Extract string value directly from the text onto the value stack.
+     * String without escapes is copied once or not at all in zero copy
+     * mode. Cursor must point to the opening quote.
+     *
+     * \param [in, out] c -- Parser position
+     * \param [in] key    -- String is an object key, long one is interned
+     * \return Return result of operation. false on error.
+     */
+    bool push_string(cursor& c, bool key);
+
+    /**
+     * Key stored in the intern table
+     *
+     * \param [in] key    -- Long key
+     * \param [in] copied -- Key would be copied into the arena without the table
+     * \return Key value which refers to the table
+     */
+    json_value intern_key(std::string_view key, bool copied);
+
+    /**
+     * Extract object key and the following ``:'' directly from the text
+     *
+     * \param [in, out] c -- Parser position
+     * \return Return result of operation. false on error.
+     */
+    bool parse_key(cursor& c);
+
+    /**
+     * Extract value which is not an array or object directly from the text
+     *
+     * \param [in, out] c -- Parser position
+     * \return Return result of operation. false on error.
+     */
+    bool parse_scalar(cursor& c);
+
+    /**
+     * Extract single value directly from the text onto the value stack.
+     * Nested arrays and objects are kept on the frame stack, so the
+     * parser does not recurse.
+     *
+     * \param [in, out] c -- Parser position
+     * \return Return result of operation. false on error.
+     */
+    bool parse_value(cursor& c);
 
   public:
 
@@ -84,12 +338,124 @@ namespace litejson
      */
     json_loader();
 
+    /**
+     * Destructor. Delete JSON tree.
+     */
+    ~json_loader();
+
+    json_loader(const json_loader&) = delete;
+    json_loader& operator=(const json_loader&) = delete;
+
     /**
      * Make JSON tree from text file
      *
      * \param [in] file_name -- Name of the JSON text file
+     * \param [in] mode      -- Parsing mode. Two pass mode is kept for comparison.
      */
-    json_loader(const std::string& file_name);
+    json_loader(const std::string& file_name, parse_mode_t mode = pm_single_pass);
+
+    /**
+     * Make JSON tree from text in memory. The text is not copied, except
+     * for the lazy mode.
+     *
+     * \param [in] data     -- JSON text
+     * \param [in] size     -- Size of the text in bytes
+     * \param [in] mode     -- Parsing mode
+     */
+    json_loader(const char* data, size_t size, parse_mode_t mode = pm_single_pass);
+
+    /**
+     * Replace JSON tree with the tree parsed from text in memory
+     *
+     * \param [in] text     -- JSON text
+     * \param [in] mode     -- Parsing mode
+     * \return Return result of operation. false on error.
+     */
+    bool load(std::string_view text, parse_mode_t mode = pm_single_pass);
+
+    /**
+     * Replace JSON tree with the tree parsed from text file. In single
+     * pass mode the file is memory mapped and parsed in place. In lazy
+     * mode the file stays mapped until the tree is deleted.
+     *
+     * \param [in] file_name -- Name of the JSON text file
+     * \param [in] mode      -- Parsing mode
+     * \return Return result of operation. false on error.
+     */
+    bool load_file(const std::string& file_name, parse_mode_t mode = pm_single_pass);
+
+    /**
+     * Parse one more document in single pass into the same arena. Trees
+     * of the previous documents stay valid till clear_tree(). Used to
+     * read streams of small documents without releasing memory for each.
+     *
+     * \param [in] text     -- JSON text, not copied
+     * \return Root of the new document or nullptr on error
+     */
+    json_value* append_document(std::string_view text);
+
+    /**
+     * Set number of the threads of the parallel mode
+     *
+     * \param [in] threads -- Number of the threads, 0 for the number of processors
+     */
+    void set_threads(unsigned threads)
+    {
+      if (threads != m_threads)
+        m_pool.reset();
+      m_threads = threads;
+    }
+
+    /**
+     * Make long strings without escapes refer to the input text instead
+     * of copying them (see json_value::as_string_view()). Only escaped
+     * strings are decoded into the arena. Text given to load() and
+     * append_document() must then live as long as the tree, files are
+     * kept mapped by the loader. Two pass mode always copies. Lazy mode
+     * keeps its text and always refers to it.
+     *
+     * \param [in] enable -- Refer to the input text
+     */
+    void set_zero_copy(bool enable) { m_zero_copy = enable; }
+
+    /**
+     * Store long object keys in the intern table instead of the arena,
+     * so every distinct key is stored once for all the documents of the
+     * loader, or of all the loaders which share the table. Lookups by
+     * the key taken from the table compare it by pointer. The current
+     * tree is deleted. Keys of the lazy mode refer to its text and are
+     * not interned.
+     *
+     * \param [in] table -- Intern table, nullptr to copy the keys
+     */
+    void set_key_table(std::shared_ptr<json_key_table> table);
+
+    /**
+     * Intern table of the keys or nullptr
+     */
+    const std::shared_ptr<json_key_table>& key_table() const { return m_keys; }
+
+    /**
+     * Set maximum nesting of arrays and objects. Deeper text fails to
+     * load with an error instead of exhausting memory. Lazy mode checks
+     * the nesting of all the brackets when the document is opened.
+     *
+     * \param [in] depth -- Maximum depth, the root array or object is at depth 1
+     */
+    void set_max_depth(size_t depth) { m_max_depth = depth; }
+
+    /**
+     * Turn statistics of the next loads on or off. While off they
+     * cost nothing. Old statistics are dropped.
+     *
+     * \param [in] enable -- Collect statistics
+     */
+    void enable_stats(bool enable);
+
+    /**
+     * Statistics of the last load or nullptr if they are off
+     */
+    const json_stats* stats() const { return m_stats.get(); }
 
     /**
      * Return state of the JSON parser. If true is return,
@@ -97,6 +463,13 @@ namespace litejson
      */
     bool bad();
 
+    /**
+     * Root element of the JSON tree or nullptr if there is no tree.
+     * The tree is owned by the loader.
+     */
+    json_value* root() { return m_root; }
+    const json_value* root() const { return m_root; }
+
     /**
      * Print JSON tree to stdout
      * 
@@ -104,7 +477,8 @@ namespace litejson
     void print_json_tree(std::ostream& stream);
 
     /**
-     * Delete JSON tree
+     * Delete JSON tree. All nodes are released with the arena
+     * at once.
      */
     void clear_tree();
 
@@ -0,0 +1,101 @@
+/**
+ * \file json_arena.cpp
+ */
+
+#include <json_arena.h>
+
+#include <cstdlib>
+
+namespace litejson
+{
+
+  static const size_t max_block_size = 4 * 1024 * 1024;
+
+/*********************  json_arena::json_arena  *******************/
+
+  json_arena::json_arena(size_t block_size)
+  : m_blocks(nullptr),
+    m_ptr(nullptr),
+    m_end(nullptr),
+    m_block_size(block_size),
+    m_block_count(0),
+    m_bytes_reserved(0)
+  {
+    // ctor
+  }
+
+/********************  json_arena::~json_arena  *******************/
+
+  json_arena::~json_arena()
+  {
+    release();
+  }
+
+/************************  json_arena::grow  **********************/
+
+  void json_arena::grow(size_t size)
+  {
+    size_t block_size = m_block_size;
+    block* b;
+
+    if (block_size < size)                              // Large object gets own block
+      block_size = size;
+    else if (m_block_size < max_block_size)             // Next blocks are bigger
+      m_block_size *= 2;
+
+    b = static_cast<block*>(std::malloc(sizeof(block) + block_size));
+    if (b == nullptr)
+      throw std::bad_alloc();
+
+    b->next = m_blocks;
+    b->size = block_size;
+    m_blocks = b;
+    m_ptr = reinterpret_cast<char*>(b + 1);
+    m_end = m_ptr + block_size;
+    m_block_count++;
+    m_bytes_reserved += block_size;
+  }
+
+/***********************  json_arena::clear  **********************/
+
+  void json_arena::clear()
+  {
+    block* keep = m_blocks;
+    block* b;
+
+    if (keep == nullptr)
+      return;
+
+    while (keep->next != nullptr)
+      {
+        b = keep->next->next;
+        std::free(keep->next);
+        keep->next = b;
+      }
+
+    m_ptr = reinterpret_cast<char*>(keep + 1);
+    m_end = m_ptr + keep->size;
+    m_block_count = 1;
+    m_bytes_reserved = keep->size;
+  }
+
+/**********************  json_arena::release  *********************/
+
+  void json_arena::release()
+  {
+    block* b;
+
+    while (m_blocks != nullptr)
+      {
+        b = m_blocks->next;
+        std::free(m_blocks);
+        m_blocks = b;
+      }
+
+    m_ptr = nullptr;
+    m_end = nullptr;
+    m_block_count = 0;
+    m_bytes_reserved = 0;
+  }
+
+}
@@ -0,0 +1,387 @@
+/**
+ * \file json_cache.cpp
+ */
+
+#include <json_cache.h>
+#include <json_writer.h>
+#include <litejson.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace litejson
+{
+
+  static const char cache_magic[8] = { 'L', 'J', 'S', 'O', 'N', 'B', 'I', 'N' };
+  static const uint32_t cache_byte_order = 0x01020304;
+
+  static inline size_t round_up(size_t size)
+  {
+    return (size + 15) & ~size_t(15);
+  }
+
+/***********************  json_cache::json_cache  *****************/
+
+  json_cache::json_cache()
+  : m_root(nullptr)
+  {
+  }
+
+/***********************  json_cache::json_cache  *****************/
+
+  json_cache::json_cache(const std::string& cache_name)
+  : m_root(nullptr)
+  {
+    open(cache_name);
+  }
+
+/**************************  json_cache::open  ********************/
+
+  bool json_cache::open(const std::string& cache_name)
+  {
+    header h;
+    char* base;
+    const char* table;
+    uint64_t at;
+    uint64_t offset;
+    char* p;
+
+    close();
+    if (!m_file.open(cache_name, true) || m_file.size() < sizeof(header))
+      {
+        close();
+        return false;
+      }
+
+    std::memcpy(&h, m_file.data(), sizeof(header));
+    if (std::memcmp(h.magic, cache_magic, sizeof(cache_magic)) != 0 || h.version != format_version ||
+        h.byte_order != cache_byte_order || h.value_size != sizeof(json_value) || h.pointer_size != sizeof(void*) ||
+        h.block_size % 8 != 0 || h.block_size < sizeof(json_value) || h.block_size > m_file.size() - sizeof(header) ||
+        h.relocations != (m_file.size() - sizeof(header) - h.block_size) / 8 ||
+        (m_file.size() - sizeof(header) - h.block_size) % 8 != 0 ||
+        h.root % 8 != 0 || h.root > h.block_size - sizeof(json_value))
+      {
+        close();
+        return false;
+      }
+
+    // Offsets of the block become pointers
+    base = m_file.writable_data() + sizeof(header);
+    table = base + h.block_size;
+    for (uint64_t i = 0; i < h.relocations; i++)
+      {
+        std::memcpy(&at, table + 8 * i, 8);
+        if (at % 8 != 0 || at > h.block_size - 8)
+          {
+            close();
+            return false;
+          }
+
+        std::memcpy(&offset, base + at, 8);
+        if (offset >= h.block_size)
+          {
+            close();
+            return false;
+          }
+
+        p = base + offset;
+        std::memcpy(base + at, &p, sizeof(p));
+      }
+
+    m_root = reinterpret_cast<const json_value*>(base + h.root);
+    return true;
+  }
+
+/*********************  json_cache::open_or_build  ****************/
+
+  bool json_cache::open_or_build(const std::string& source_name, const std::string& cache_name)
+  {
+    if (!is_stale(cache_name, source_name) && open(cache_name))
+      return true;
+
+    return build(source_name, cache_name) && open(cache_name);
+  }
+
+/**************************  json_cache::close  *******************/
+
+  void json_cache::close()
+  {
+    m_root = nullptr;
+    m_file.close();
+  }
+
+/*************************  json_cache::measure  ******************/
+
+  size_t json_cache::measure(const json_value& val)
+  {
+    size_t size = 0;
+    size_t i;
+
+    if (val.m_header.type & json_value::f_lazy)
+      val.expand();
+
+    switch (val.type())
+      {
+
+      case json_value::t_string:
+        if (!(val.m_header.type & json_value::f_short))
+          size = round_up(val.m_string.size + 1);
+        break;
+
+      case json_value::t_array:
+        size = round_up(val.m_array.size * sizeof(json_value));
+        for (i = 0; i < val.m_array.size; i++)
+          size += measure(val.m_array.items[i]);
+        break;
+
+      case json_value::t_object:
+        size = val.m_object.size * sizeof(json_member);
+        if (val.m_object.size >= json_value::index_min)
+          size += json_value::index_size(val.m_object.size) * sizeof(json_value::index_slot);
+        size = round_up(size);
+        for (i = 0; i < val.m_object.size; i++)
+          size += measure(val.m_object.members[i].name) + measure(val.m_object.members[i].value);
+        break;
+
+      default:
+        break;
+
+      }
+
+    return size;
+  }
+
+/***************************  json_cache::copy  *******************/
+
+  void json_cache::copy(json_value& dst, const json_value& src, char*& free, std::vector<char*>& relocations)
+  {
+    size_t size;
+    size_t i;
+
+    new (&dst) json_value();
+    switch (src.type())
+      {
+
+      case json_value::t_string:
+        if (src.m_header.type & json_value::f_short)
+          {
+            dst.m_short = src.m_short;
+            break;
+          }
+        size = src.m_string.size;
+        std::memcpy(free, src.m_string.chars, size);
+        dst.m_string.type = json_value::t_string;
+        dst.m_string.size = size;
+        dst.m_string.chars = free;
+        relocations.push_back(reinterpret_cast<char*>(&dst.m_string.chars));
+        free += round_up(size + 1);
+        break;
+
+      case json_value::t_array:
+        size = src.m_array.size;
+        dst.m_array.type = json_value::t_array;
+        dst.m_array.size = size;
+        if (size == 0)
+          break;
+        dst.m_array.items = reinterpret_cast<json_value*>(free);
+        relocations.push_back(reinterpret_cast<char*>(&dst.m_array.items));
+        free += round_up(size * sizeof(json_value));
+        for (i = 0; i < size; i++)
+          copy(dst.m_array.items[i], src.m_array.items[i], free, relocations);
+        break;
+
+      case json_value::t_object:
+        size = src.m_object.size;
+        dst.m_object.type = json_value::t_object;
+        dst.m_object.size = size;
+        if (size == 0)
+          break;
+        dst.m_object.members = reinterpret_cast<json_member*>(free);
+        relocations.push_back(reinterpret_cast<char*>(&dst.m_object.members));
+        free += round_up(size * sizeof(json_member) +
+                         (size >= json_value::index_min ? json_value::index_size(size) * sizeof(json_value::index_slot) : 0));
+        for (i = 0; i < size; i++)
+          {
+            copy(dst.m_object.members[i].name, src.m_object.members[i].name, free, relocations);
+            copy(dst.m_object.members[i].value, src.m_object.members[i].value, free, relocations);
+          }
+        if (size >= json_value::index_min)
+          {
+            dst.m_object.type |= json_value::f_indexed;
+            dst.build_index();
+          }
+        break;
+
+      default:
+        dst.m_scalar = src.m_scalar;
+        break;
+
+      }
+  }
+
+/**************************  json_cache::write  *******************/
+
+  bool json_cache::write(const json_value& root, const std::string& cache_name, const std::string& source_name)
+  {
+    uint64_t source_size = 0;
+    int64_t source_time = 0;
+
+    if (!source_name.empty() && !file_time(source_name, &source_size, &source_time))
+      return false;
+
+    return write_file(root, cache_name, source_size, source_time);
+  }
+
+/***********************  json_cache::write_file  *****************/
+
+  bool json_cache::write_file(const json_value& root, const std::string& cache_name, uint64_t source_size, int64_t source_time)
+  {
+    std::vector<char*> relocations;
+    std::vector<uint64_t> table;
+    size_t size = sizeof(json_value) + measure(root);
+    std::unique_ptr<uint64_t[]> block(new uint64_t[size / 8]());  // Zero padding makes same files
+    char* base = reinterpret_cast<char*>(block.get());
+    char* free = base + sizeof(json_value);
+    std::string temp_name = cache_name + ".XXXXXX";   // Unique, so concurrent builders do not mix their files
+    header h;
+    uint64_t offset;
+    FILE* file;
+    int fd;
+    bool ok;
+
+    copy(*reinterpret_cast<json_value*>(base), root, free, relocations);
+
+    // Pointers become offsets of the block
+    table.reserve(relocations.size());
+    for (char* at : relocations)
+      {
+        char* p;
+
+        std::memcpy(&p, at, sizeof(p));
+        offset = p - base;
+        std::memcpy(at, &offset, 8);
+        table.push_back(at - base);
+      }
+
+    std::memset(&h, 0, sizeof(header));
+    std::memcpy(h.magic, cache_magic, sizeof(cache_magic));
+    h.version = format_version;
+    h.byte_order = cache_byte_order;
+    h.value_size = sizeof(json_value);
+    h.pointer_size = sizeof(void*);
+    h.source_size = source_size;
+    h.source_time = source_time;
+    h.root = 0;
+    h.block_size = size;
+    h.relocations = table.size();
+
+    // Readers of the old cache keep their mapping, so the file is replaced at once
+    fd = mkstemp(&temp_name[0]);
+    if (fd < 0)
+      return false;
+    fchmod(fd, 0644);                                   // mkstemp() makes the file private
+    file = fdopen(fd, "wb");
+    if (file == nullptr)
+      {
+        ::close(fd);
+        std::remove(temp_name.c_str());
+        return false;
+      }
+
+    ok = std::fwrite(&h, sizeof(header), 1, file) == 1 &&
+         std::fwrite(base, size, 1, file) == 1 &&
+         std::fwrite(table.data(), 8, table.size(), file) == table.size();
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok || std::rename(temp_name.c_str(), cache_name.c_str()) != 0)
+      {
+        std::remove(temp_name.c_str());
+        return false;
+      }
+    return true;
+  }
+
+/**************************  json_cache::build  *******************/
+
+  bool json_cache::build(const std::string& source_name, const std::string& cache_name)
+  {
+    json_loader loader;
+    uint64_t size;
+    int64_t time;
+    uint64_t size_after;
+    int64_t time_after;
+
+    // Time is taken before the text is read, so a change during the parse makes the cache stale
+    if (!file_time(source_name, &size, &time) || !loader.load_file(source_name))
+      return false;
+
+    if (!write_file(*loader.root(), cache_name, size, time))
+      return false;
+
+    // Text changed while the cache was made, the cache is stale already
+    return file_time(source_name, &size_after, &time_after) && size_after == size && time_after == time;
+  }
+
+/************************  json_cache::write_text  ****************/
+
+  bool json_cache::write_text(const std::string& file_name, int indent) const
+  {
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+
+    if (m_root == nullptr || !file)
+      return false;
+
+    json_writer writer([&](std::string_view text) { file.write(text.data(), text.size()); }, indent);
+
+    writer.write(*m_root);
+    writer.flush();
+
+    return bool(file.flush());
+  }
+
+/*************************  json_cache::is_stale  *****************/
+
+  bool json_cache::is_stale(const std::string& cache_name, const std::string& source_name)
+  {
+    std::ifstream file(cache_name, std::ios::binary);
+    header h;
+    uint64_t size;
+    int64_t time;
+
+    if (!file.read(reinterpret_cast<char*>(&h), sizeof(header)) ||
+        std::memcmp(h.magic, cache_magic, sizeof(cache_magic)) != 0 || h.version != format_version ||
+        h.byte_order != cache_byte_order || h.value_size != sizeof(json_value) || h.pointer_size != sizeof(void*))
+      return true;
+
+    if (!file_time(source_name, &size, &time))
+      return true;
+
+    return size != h.source_size || time != h.source_time;
+  }
+
+/************************  json_cache::file_time  *****************/
+
+  bool json_cache::file_time(const std::string& file_name, uint64_t* size, int64_t* time)
+  {
+    struct stat st;
+
+    if (stat(file_name.c_str(), &st) != 0)
+      return false;
+
+    *size = st.st_size;
+#if defined(__linux__)
+    *time = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+    *time = int64_t(st.st_mtime) * 1000000000;
+#endif
+    return true;
+  }
+
+}
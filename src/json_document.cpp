@@ -0,0 +1,29 @@
+/**
+ * \file json_document.cpp
+ */
+
+#include <json_document.h>
+
+namespace litejson
+{
+
+/*****************  json_document::json_document  *****************/
+
+  json_document::json_document(std::string_view text, json_loader::parse_mode_t mode)
+  {
+    m_loader.load(text, mode == json_loader::pm_lazy ? json_loader::pm_single_pass : mode);
+  }
+
+/*********************  json_document::from_file  *****************/
+
+  std::unique_ptr<json_document> json_document::from_file(const std::string& file_name,
+                                                          json_loader::parse_mode_t mode)
+  {
+    std::unique_ptr<json_document> doc(new json_document());
+
+    doc->m_loader.set_zero_copy(true);
+    doc->m_loader.load_file(file_name, mode == json_loader::pm_lazy ? json_loader::pm_single_pass : mode);
+    return doc;
+  }
+
+}
@@ -0,0 +1,184 @@
+/**
+ * \file json_key_table.cpp
+ */
+
+#include <json_key_table.h>
+#include <json_value.h>
+
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace litejson
+{
+
+/*****************  json_key_table::json_key_table  ***************/
+
+  json_key_table::json_key_table()
+  : m_bytes(0),
+    m_max_bytes(std::numeric_limits<size_t>::max())
+  {
+    for (shard& s : m_shards)
+      {
+        s.slots.assign(64, slot{0, 0, nullptr});
+        s.count = s.bytes = 0;
+        s.hits = s.saved = 0;
+      }
+  }
+
+/********************  json_key_table::find_slot  *****************/
+
+  size_t json_key_table::find_slot(const shard& s, std::string_view key, uint32_t hash)
+  {
+    size_t mask = s.slots.size() - 1;
+    size_t i;
+
+    for (i = hash & mask; s.slots[i].chars != nullptr; i = (i + 1) & mask)
+      {
+        if (s.slots[i].hash == hash && s.slots[i].size == key.size() &&
+            std::memcmp(s.slots[i].chars, key.data(), key.size()) == 0)
+          break;
+      }
+
+    return i;
+  }
+
+/*********************  json_key_table::rehash  *******************/
+
+  void json_key_table::rehash(shard& s)
+  {
+    std::vector<slot> old(2 * s.slots.size(), slot{0, 0, nullptr});
+    size_t mask = old.size() - 1;
+    size_t i;
+
+    old.swap(s.slots);
+    for (const slot& o : old)
+      {
+        if (o.chars == nullptr)
+          continue;
+        for (i = o.hash & mask; s.slots[i].chars != nullptr; i = (i + 1) & mask)
+          ;
+        s.slots[i] = o;
+      }
+  }
+
+/**********************  json_key_table::hit  *********************/
+
+  std::string_view json_key_table::hit(shard& s, size_t i, bool* added)
+  {
+    s.hits.fetch_add(1, std::memory_order_relaxed);
+    s.saved.fetch_add(s.slots[i].size + 1, std::memory_order_relaxed);
+    if (added != nullptr)
+      *added = false;
+    return std::string_view(s.slots[i].chars, s.slots[i].size);
+  }
+
+/*********************  json_key_table::intern  *******************/
+
+  std::string_view json_key_table::intern(std::string_view key, bool* added)
+  {
+    uint32_t hash = json_value::hash(key);
+    shard& s = shard_of(hash);
+    size_t i;
+    char* chars;
+
+    {
+      std::shared_lock<std::shared_mutex> guard(s.lock);   // Known keys are found by all threads at once
+
+      i = find_slot(s, key, hash);
+      if (s.slots[i].chars != nullptr)
+        return hit(s, i, added);
+    }
+
+    std::lock_guard<std::shared_mutex> guard(s.lock);
+    i = find_slot(s, key, hash);                        // Other thread may add the key meanwhile
+    if (s.slots[i].chars != nullptr)
+      return hit(s, i, added);
+
+    if (added != nullptr)
+      *added = false;
+    if (m_bytes + key.size() + 1 > m_max_bytes)         // Table is full
+      return std::string_view();
+
+    chars = static_cast<char*>(s.arena.allocate(key.size() + 1, 1));
+    std::memcpy(chars, key.data(), key.size());
+    chars[key.size()] = 0;
+    s.slots[i] = slot{hash, uint32_t(key.size()), chars};
+    s.count++;
+    s.bytes += key.size() + 1;
+    m_bytes += key.size() + 1;
+
+    if (2 * s.count > s.slots.size())                   // Load factor stays below one half
+      rehash(s);
+
+    if (added != nullptr)
+      *added = true;
+    return std::string_view(chars, key.size());
+  }
+
+/**********************  json_key_table::find  ********************/
+
+  std::string_view json_key_table::find(std::string_view key) const
+  {
+    uint32_t hash = json_value::hash(key);
+    const shard& s = shard_of(hash);
+    std::shared_lock<std::shared_mutex> guard(s.lock);
+    size_t i = find_slot(s, key, hash);
+
+    return std::string_view(s.slots[i].chars, s.slots[i].chars != nullptr ? s.slots[i].size : 0);
+  }
+
+/*********************  json_key_table::clear  ********************/
+
+  void json_key_table::clear()
+  {
+    for (shard& s : m_shards)
+      {
+        std::lock_guard<std::shared_mutex> guard(s.lock);
+
+        s.slots.assign(64, slot{0, 0, nullptr});
+        s.arena.clear();
+        s.count = s.bytes = 0;
+        s.hits = s.saved = 0;
+      }
+    m_bytes = 0;
+  }
+
+/**********************  json_key_table::size  ********************/
+
+  size_t json_key_table::size() const
+  {
+    size_t count = 0;
+
+    for (const shard& s : m_shards)
+      {
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+
+        count += s.count;
+      }
+    return count;
+  }
+
+/**********************  json_key_table::hits  ********************/
+
+  size_t json_key_table::hits() const
+  {
+    size_t hits = 0;
+
+    for (const shard& s : m_shards)
+      hits += s.hits;
+    return hits;
+  }
+
+/******************  json_key_table::bytes_saved  *****************/
+
+  size_t json_key_table::bytes_saved() const
+  {
+    size_t saved = 0;
+
+    for (const shard& s : m_shards)
+      saved += s.saved;
+    return saved;
+  }
+
+}
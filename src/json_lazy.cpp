@@ -0,0 +1,249 @@
+/**
+ * \file json_lazy.cpp
+ */
+
+#include <json_lazy.h>
+#include <json_number.h>
+#include <json_scan.h>
+#include <json_string.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+namespace litejson
+{
+
+/**********************  json_lazy::json_lazy  ********************/
+
+  json_lazy::json_lazy()
+  : m_text(nullptr),
+    m_size(0),
+    m_arena(nullptr),
+    m_expanded(0),
+    m_max_depth(std::numeric_limits<size_t>::max()),
+    m_too_deep(false)
+  {
+  }
+
+/*********************  json_lazy::syntax_error  ******************/
+
+  void json_lazy::syntax_error()
+  {
+    throw std::runtime_error("syntax error in lazy document");
+  }
+
+/************************  json_lazy::close  **********************/
+
+  void json_lazy::close()
+  {
+    m_text = nullptr;
+    m_size = 0;
+    m_arena = nullptr;
+    m_containers.clear();
+    m_items.clear();
+    m_expanded = 0;
+  }
+
+/*************************  json_lazy::open  **********************/
+
+  bool json_lazy::open(const char* text, size_t size, json_arena& arena, json_value& root)
+  {
+    std::vector<uint32_t> brackets;
+    std::vector<uint32_t> stack;
+    const char* end = text + size;
+    const char* p;
+    int lines = 0;
+
+    close();
+    m_too_deep = false;
+    if (size > UINT32_MAX || !bracket_index(text, size, brackets))
+      return false;
+
+    m_containers.reserve(brackets.size() / 2);
+    for (uint32_t offset : brackets)                    // Match the brackets
+      {
+        if (text[offset] == '{' || text[offset] == '[')
+          {
+            if (stack.size() >= m_max_depth)
+              {
+                m_containers.clear();
+                m_too_deep = true;
+                return false;
+              }
+            stack.push_back(m_containers.size());
+            m_containers.push_back(container{offset, 0, 0});
+            continue;
+          }
+
+        if (stack.empty() || text[offset] != text[m_containers[stack.back()].open] + 2)
+          {
+            m_containers.clear();
+            return false;
+          }
+        m_containers[stack.back()].close = offset;
+        m_containers[stack.back()].next = m_containers.size();
+        stack.pop_back();
+      }
+
+    m_text = text;
+    m_size = size;
+    m_arena = &arena;
+
+    p = skip_whitespace(text, end, &lines);
+    if (p == end)                                       // Empty text
+      p = nullptr;
+    else if (*p == '{' || *p == '[')
+      {
+        root = make_lazy(0);
+        p = text + m_containers[0].close + 1;
+      }
+    else
+      p = parse_scalar(p, end, root);
+
+    if (p != nullptr)
+      p = skip_whitespace(p, end, &lines);
+
+    if (p != end)                                       // Error or garbage after the value
+      {
+        root = json_value();
+        close();
+        return false;
+      }
+
+    return true;
+  }
+
+/***********************  json_lazy::make_lazy  *******************/
+
+  json_value json_lazy::make_lazy(uint32_t index)
+  {
+    json_value val;
+
+    val.m_lazy.type = uint8_t((m_text[m_containers[index].open] == '{' ? json_value::t_object : json_value::t_array) | json_value::f_lazy);
+    val.m_lazy.container = index;
+    val.m_lazy.document = this;
+    return val;
+  }
+
+/**********************  json_lazy::parse_string  *****************/
+
+  const char* json_lazy::parse_string(const char* p, const char* end, json_value& val)
+  {
+    const char* stop = scan_string(p + 1, end);
+
+    if (stop != end && *stop == '\"' && validate_utf8(p + 1, stop - p - 1))
+      {
+        val = json_value(std::string_view(p + 1, stop - p - 1), json_value::view);
+        return stop + 1;
+      }
+
+    p = decode_string(p + 1, end, m_scratch);
+    if (p != nullptr)
+      val = json_value(m_scratch, *m_arena);
+    return p;
+  }
+
+/**********************  json_lazy::parse_scalar  *****************/
+
+  const char* json_lazy::parse_scalar(const char* p, const char* end, json_value& val)
+  {
+    switch (*p)
+      {
+
+      case '\"':                                        // String
+        return parse_string(p, end, val);
+
+      case 'n':                                         // Null
+        if (end - p >= 4 && std::equal(p, p + 4, "null"))
+          {
+            val = json_value();
+            return p + 4;
+          }
+        return nullptr;
+
+      case 't':                                         // Boolean
+        if (end - p >= 4 && std::equal(p, p + 4, "true"))
+          {
+            val = json_value(true);
+            return p + 4;
+          }
+        return nullptr;
+
+      case 'f':
+        if (end - p >= 5 && std::equal(p, p + 5, "false"))
+          {
+            val = json_value(false);
+            return p + 5;
+          }
+        return nullptr;
+
+      default:                                          // Number
+        return parse_number(p, end, val);
+
+      }
+  }
+
+/**********************  json_lazy::materialize  ******************/
+
+  void json_lazy::materialize(json_value& val)
+  {
+    uint32_t index = val.m_lazy.container;
+    uint32_t child = index + 1;
+    const char* p = m_text + m_containers[index].open + 1;
+    const char* end = m_text + m_containers[index].close;
+    bool object = m_text[m_containers[index].open] == '{';
+    int lines = 0;
+
+    m_items.clear();
+    p = skip_whitespace(p, end, &lines);
+    while (p != end)
+      {
+        if (object)                                     // Get name and :
+          {
+            m_items.emplace_back();
+            if (*p != '\"' || (p = parse_string(p, end, m_items.back())) == nullptr)
+              syntax_error();
+
+            p = skip_whitespace(p, end, &lines);
+            if (p == end || *p != ':')
+              syntax_error();
+            p = skip_whitespace(p + 1, end, &lines);
+            if (p == end)
+              syntax_error();
+          }
+
+        if (*p == '{' || *p == '[')                     // Nested container is skipped
+          {
+            if (child >= m_containers.size() || m_text + m_containers[child].open != p)
+              syntax_error();
+            m_items.push_back(make_lazy(child));
+            p = m_text + m_containers[child].close + 1;
+            child = m_containers[child].next;
+          }
+        else
+          {
+            m_items.emplace_back();
+            if ((p = parse_scalar(p, end, m_items.back())) == nullptr)
+              syntax_error();
+          }
+
+        p = skip_whitespace(p, end, &lines);
+        if (p == end)
+          break;
+        if (*p != ',')
+          syntax_error();
+        p = skip_whitespace(p + 1, end, &lines);
+        if (p == end)                                   // Comma before the closing bracket
+          syntax_error();
+      }
+
+    if (object)
+      val.assign_object(m_items.data(), m_items.size() / 2, *m_arena);
+    else
+      val.assign_array(m_items.data(), m_items.size(), *m_arena);
+    m_items.clear();
+    m_expanded++;
+  }
+
+}
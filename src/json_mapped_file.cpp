@@ -0,0 +1,161 @@
+/**
+ * \file json_mapped_file.cpp
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <json_mapped_file.h>
+
+#include <cerrno>
+#include <fstream>
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define LITEJSON_USE_MMAP
+#endif
+
+namespace litejson
+{
+
+  static const size_t read_chunk = 64 * 1024;           // Bytes read at once from the file which is not mapped
+
+/**************  json_mapped_file::json_mapped_file  **************/
+
+  json_mapped_file::json_mapped_file()
+  : m_data(nullptr),
+    m_size(0),
+    m_mapped(false),
+    m_writable(false)
+  {
+    // ctor
+  }
+
+/**************  json_mapped_file::json_mapped_file  **************/
+
+  json_mapped_file::json_mapped_file(const std::string& file_name)
+  : m_data(nullptr),
+    m_size(0),
+    m_mapped(false),
+    m_writable(false)
+  {
+    open(file_name);
+  }
+
+/*************  json_mapped_file::~json_mapped_file  **************/
+
+  json_mapped_file::~json_mapped_file()
+  {
+    close();
+  }
+
+/********************  json_mapped_file::open  ********************/
+
+  bool json_mapped_file::open(const std::string& file_name, bool copy_on_write)
+  {
+    size_t count;
+
+    close();
+
+#ifdef LITEJSON_USE_MMAP
+    int fd;
+    struct stat st;
+    void* p;
+    ssize_t n;
+
+    fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    if (fstat(fd, &st) != 0)
+      {
+        ::close(fd);
+        return false;
+      }
+
+    // Only regular files are mapped. Size of pipes, devices and /proc files is unknown, they are read till the end.
+    if (S_ISREG(st.st_mode) && st.st_size != 0)
+      {
+        p = mmap(nullptr, st.st_size, copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+          {
+            ::close(fd);
+#ifdef MADV_SEQUENTIAL
+            if (!copy_on_write)
+              madvise(p, st.st_size, MADV_SEQUENTIAL);
+#endif
+            m_data = static_cast<const char*>(p);
+            m_size = st.st_size;
+            m_mapped = true;
+            m_writable = copy_on_write;
+            return true;
+          }
+        m_buffer.reserve(st.st_size);
+      }
+
+    do
+      {
+        count = m_buffer.size();
+        m_buffer.resize(count + read_chunk);
+        do
+          n = ::read(fd, &m_buffer[count], read_chunk);
+        while (n < 0 && errno == EINTR);
+        m_buffer.resize(count + (n > 0 ? n : 0));
+      }
+    while (n > 0);
+    ::close(fd);
+
+    if (n < 0)
+      {
+        m_buffer.clear();
+        return false;
+      }
+#else
+    std::ifstream ifs(file_name, std::ios::binary);
+
+    if (!ifs)
+      return false;
+
+    while (ifs)                                         // Size of the stream is unknown, e.g. for pipe
+      {
+        count = m_buffer.size();
+        m_buffer.resize(count + read_chunk);
+        ifs.read(&m_buffer[count], read_chunk);
+        m_buffer.resize(count + ifs.gcount());
+      }
+
+    if (ifs.bad())
+      {
+        m_buffer.clear();
+        return false;
+      }
+#endif
+
+    m_data = m_buffer.c_str();
+    m_size = m_buffer.size();
+    m_writable = copy_on_write;
+    return true;
+  }
+
+/*******************  json_mapped_file::close  ********************/
+
+  void json_mapped_file::close()
+  {
+#ifdef LITEJSON_USE_MMAP
+    if (m_mapped)
+      munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_writable = false;
+  }
+
+}
@@ -0,0 +1,115 @@
+/**
+ * \file json_number.cpp
+ */
+
+#include <json_number.h>
+
+#include <charconv>
+#include <limits>
+
+namespace litejson
+{
+
+  static inline bool is_digit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+/**************************  parse_number  ************************/
+
+  const char* parse_number(const char* begin, const char* end, json_value& val)
+  {
+    const char* it = begin;
+    bool negative = false;
+    bool integer = true;
+    bool exponent_negative = false;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    double d;
+
+    if (it != end && *it == '-')                        // Extract mantissa sign
+      {
+        negative = true;
+        it++;
+      }
+
+    if (it == end || !is_digit(*it))                    // Extract mantissa integer part
+      return nullptr;
+
+    if (*it == '0')                                     // No leading zeros
+      it++;
+    else
+      {
+        while (it != end && is_digit(*it))
+          {
+            mantissa = mantissa * 10 + (*it - '0');
+            digits++;
+            it++;
+          }
+      }
+
+    if (it != end && *it == '.')                        // Extract fractional part
+      {
+        integer = false;
+        it++;
+        if (it == end || !is_digit(*it))
+          return nullptr;
+        while (it != end && is_digit(*it))
+          it++;
+      }
+
+    if (it != end && (*it == 'e' || *it == 'E'))        // Extract exponent
+      {
+        integer = false;
+        it++;
+        if (it != end && (*it == '-' || *it == '+'))
+          {
+            exponent_negative = (*it == '-');
+            it++;
+          }
+        if (it == end || !is_digit(*it))
+          return nullptr;
+        while (it != end && is_digit(*it))
+          it++;
+      }
+
+    if (integer && digits <= 19)                        // 19 digits never overflow uint64
+      {
+        if (!negative)
+          val = json_value((unsigned long long)mantissa);
+        else if (mantissa != 0 && mantissa <= uint64_t(std::numeric_limits<int64_t>::max()) + 1)
+          val = json_value((long long)(0 - mantissa));
+        else
+          integer = false;                              // -0 keeps its sign as double
+        if (integer)
+          return it;
+      }
+
+    if (integer && digits == 20 && !negative)           // May still fit uint64
+      {
+        uint64_t u;
+        auto r = std::from_chars(begin, it, u);
+
+        if (r.ec == std::errc())
+          {
+            val = json_value((unsigned long long)u);
+            return it;
+          }
+      }
+
+    auto r = std::from_chars(begin, it, d);             // Correctly rounded conversion
+
+    if (r.ec == std::errc::result_out_of_range)
+      {
+        d = exponent_negative ? 0.0 : std::numeric_limits<double>::infinity();
+        if (negative)
+          d = -d;
+      }
+    else if (r.ec != std::errc())
+      return nullptr;
+
+    val = json_value(d);
+    return it;
+  }
+
+}
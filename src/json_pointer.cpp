@@ -0,0 +1,115 @@
+/**
+ * \file json_pointer.cpp
+ */
+
+#include <json_pointer.h>
+
+#include <stdexcept>
+
+namespace litejson
+{
+
+/*******************  json_pointer::json_pointer  *****************/
+
+  json_pointer::json_pointer(std::string_view pointer)
+  {
+    if (!compile(pointer))
+      throw std::runtime_error("is not a JSON pointer");
+  }
+
+/*********************  json_pointer::unescape  *******************/
+
+  bool json_pointer::unescape(std::string_view token, std::string& out)
+  {
+    out.clear();
+    for (size_t i = 0; i < token.size(); i++)
+      {
+        if (token[i] != '~')
+          out.push_back(token[i]);
+        else if (i + 1 < token.size() && token[i + 1] == '0')
+          out.push_back('~'), i++;
+        else if (i + 1 < token.size() && token[i + 1] == '1')
+          out.push_back('/'), i++;
+        else
+          return false;
+      }
+
+    return true;
+  }
+
+/*******************  json_pointer::array_index  ******************/
+
+  int64_t json_pointer::array_index(std::string_view token)
+  {
+    int64_t index = 0;
+
+    if (token.empty() || token.size() > 18 || (token[0] == '0' && token.size() != 1))
+      return -1;
+
+    for (char c : token)
+      {
+        if (c < '0' || c > '9')
+          return -1;
+        index = index * 10 + (c - '0');
+      }
+
+    return index;
+  }
+
+/*********************  json_pointer::compile  ********************/
+
+  bool json_pointer::compile(std::string_view pointer)
+  {
+    std::string name;
+    size_t next;
+
+    m_names.clear();
+    m_segments.clear();
+
+    if (pointer.empty())
+      return true;
+    if (pointer[0] != '/')
+      return false;
+
+    while (!pointer.empty())
+      {
+        pointer.remove_prefix(1);                       // Skip '/'
+        next = pointer.find('/');
+        if (!unescape(pointer.substr(0, next), name))
+          {
+            m_names.clear();
+            m_segments.clear();
+            return false;
+          }
+        pointer = next == std::string_view::npos ? std::string_view() : pointer.substr(next);
+
+        m_segments.push_back(segment{m_names.size(), name.size(), json_value::hash(name), array_index(name)});
+        m_names += name;
+      }
+
+    return true;
+  }
+
+/*********************  json_pointer::resolve  ********************/
+
+  const json_value* json_pointer::resolve(const json_value& root) const
+  {
+    const json_value* node = &root;
+
+    for (const segment& s : m_segments)
+      {
+        if (node->is_object())
+          node = node->as_object(std::string_view(m_names.data() + s.offset, s.size), s.hash);
+        else if (node->is_array() && s.index >= 0 && s.index <= INT32_MAX)
+          node = node->as_array(int(s.index));
+        else
+          return nullptr;
+
+        if (node == nullptr)
+          return nullptr;
+      }
+
+    return node;
+  }
+
+}
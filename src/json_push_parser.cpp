@@ -0,0 +1,329 @@
+/**
+ * \file json_push_parser.cpp
+ */
+
+#include <json_push_parser.h>
+#include <json_number.h>
+#include <json_scan.h>
+#include <json_string.h>
+
+#include <iostream>
+
+namespace litejson
+{
+
+  static inline bool is_alpha(char c)
+  {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+  }
+
+  static inline bool is_number_char(char c)
+  {
+    return is_class(c, c_digit) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+  }
+
+/****************  json_push_parser::json_push_parser  ************/
+
+  json_push_parser::json_push_parser()
+  : m_root(nullptr),
+    m_max_depth(default_max_depth),
+    m_log(&std::cerr)
+  {
+    reset();
+  }
+
+/***************  json_push_parser::~json_push_parser  ************/
+
+  json_push_parser::~json_push_parser()
+  {
+    reset();
+  }
+
+/*********************  json_push_parser::reset  ******************/
+
+  void json_push_parser::reset()
+  {
+    if (m_root != nullptr)
+      m_root->release_owned();
+    m_root = nullptr;
+    m_badbit = false;
+    m_line = 1;
+    m_state = s_value;
+    m_kind = k_none;
+    m_escape = false;
+    m_token.clear();
+    m_stack.clear();
+    m_frames.clear();
+    m_arena.clear();
+  }
+
+/*********************  json_push_parser::error  ******************/
+
+  bool json_push_parser::error(const char* what)
+  {
+    if (m_log != nullptr)
+      *m_log << "Syntax error (" << m_line << "): " << what << std::endl;
+    m_badbit = true;
+    return false;
+  }
+
+/*******************  json_push_parser::end_value  ****************/
+
+  void json_push_parser::end_value()
+  {
+    m_state = m_frames.empty() ? s_done : s_next;
+  }
+
+/*****************  json_push_parser::end_container  **************/
+
+  void json_push_parser::end_container()
+  {
+    frame f = m_frames.back();
+    json_value val;
+
+    m_frames.pop_back();
+    if (f.object)
+      val.assign_object(m_stack.data() + f.base, (m_stack.size() - f.base) / 2, m_arena);
+    else
+      val.assign_array(m_stack.data() + f.base, m_stack.size() - f.base, m_arena);
+    m_stack.resize(f.base);
+    m_stack.push_back(std::move(val));
+    end_value();
+  }
+
+/*******************  json_push_parser::end_token  ****************/
+
+  bool json_push_parser::end_token(const char* begin, const char* end)
+  {
+    std::string_view text(begin, end - begin);
+    token_t kind = m_kind;
+
+    m_kind = k_none;
+    switch (kind)
+      {
+
+      case k_string:
+      case k_key:
+        if (decode_string(begin, end, m_scratch) != end)
+          return error("Bad string");
+        m_stack.emplace_back(m_scratch, m_arena);
+        break;
+
+      case k_number:
+        m_stack.emplace_back();
+        if (parse_number(begin, end, m_stack.back()) != end)
+          return error("Bad number");
+        break;
+
+      case k_literal:
+        if (text == "null")
+          m_stack.emplace_back();
+        else if (text == "true")
+          m_stack.emplace_back(true);
+        else if (text == "false")
+          m_stack.emplace_back(false);
+        else
+          return error("Unknown literal");
+        break;
+
+      default:
+        break;
+
+      }
+
+    m_token.clear();
+    if (kind == k_key)
+      m_state = s_colon;
+    else
+      end_value();
+    return true;
+  }
+
+/*******************  json_push_parser::scan_token  ***************/
+
+  const char* json_push_parser::scan_token(const char* p, const char* end)
+  {
+    const char* q = p;
+    bool done = false;
+
+    if (m_kind == k_string || m_kind == k_key)
+      {
+        if (m_escape && q != end)                       // Escaped character is in this chunk
+          {
+            q++;
+            m_escape = false;
+          }
+
+        while (q != end)
+          {
+            q = scan_string(q, end);
+            if (q == end)
+              break;
+            if (*q == '\"')
+              {
+                q++;                                    // Closing quote is passed to decode_string()
+                done = true;
+                break;
+              }
+            if (*q != '\\')
+              {
+                error("Control character in string");
+                return nullptr;
+              }
+            if (q + 1 == end)                           // Escape is split
+              {
+                m_escape = true;
+                q = end;
+                break;
+              }
+            q += 2;
+          }
+      }
+    else
+      {
+        while (q != end && (m_kind == k_number ? is_number_char(*q) : is_alpha(*q)))
+          q++;
+        done = q != end;
+      }
+
+    if (!done)                                          // Keep the characters till the next chunk
+      {
+        m_token.append(p, end);
+        return end;
+      }
+
+    if (m_token.empty())                                // Whole token is in the chunk
+      return end_token(p, q) ? q : nullptr;
+
+    m_token.append(p, q);
+    return end_token(m_token.data(), m_token.data() + m_token.size()) ? q : nullptr;
+  }
+
+/*********************  json_push_parser::feed  *******************/
+
+  bool json_push_parser::feed(const char* data, size_t size)
+  {
+    const char* p = data;
+    const char* end = data + size;
+
+    if (m_badbit)
+      return false;
+    if (m_root != nullptr)
+      return error("Text after finish");
+
+    if (m_kind != k_none && (p = scan_token(p, end)) == nullptr)
+      return false;
+
+    while (p != end)
+      {
+        p = skip_whitespace(p, end, &m_line);
+        if (p == end)
+          break;
+
+        switch (m_state)
+          {
+
+          case s_done:
+            return error("Text after the end of JSON value");
+
+          case s_colon:
+            if (*p != ':')
+              return error("``:'' expected");
+            p++;
+            m_state = s_value;
+            continue;
+
+          case s_next:
+            if (*p == ',')
+              {
+                p++;
+                m_state = m_frames.back().object ? s_key : s_value;
+                continue;
+              }
+            if (*p == (m_frames.back().object ? '}' : ']'))
+              {
+                p++;
+                end_container();
+                continue;
+              }
+            return error("``,'' or closing bracket expected");
+
+          case s_first_key:
+            if (*p == '}')
+              {
+                p++;
+                end_container();
+                continue;
+              }
+            // fall through
+
+          case s_key:
+            if (*p != '\"')
+              return error("String expected");
+            m_kind = k_key;
+            p++;
+            break;
+
+          case s_first_value:
+            if (*p == ']')
+              {
+                p++;
+                end_container();
+                continue;
+              }
+            // fall through
+
+          case s_value:
+            if (*p == '{' || *p == '[')
+              {
+                if (m_frames.size() >= m_max_depth)
+                  return error("Nesting is too deep");
+                m_frames.push_back(frame{m_stack.size(), *p == '{'});
+                m_state = *p == '{' ? s_first_key : s_first_value;
+                p++;
+                continue;
+              }
+
+            if (*p == '\"')
+              {
+                m_kind = k_string;
+                p++;
+              }
+            else if (*p == '-' || is_class(*p, c_digit))
+              m_kind = k_number;
+            else if (is_alpha(*p))
+              m_kind = k_literal;
+            else
+              return error("Value expected");
+            break;
+
+          }
+
+        if ((p = scan_token(p, end)) == nullptr)
+          return false;
+      }
+
+    return true;
+  }
+
+/********************  json_push_parser::finish  ******************/
+
+  bool json_push_parser::finish()
+  {
+    if (m_badbit)
+      return false;
+    if (m_root != nullptr)
+      return true;
+
+    if ((m_kind == k_number || m_kind == k_literal) && !end_token(m_token.data(), m_token.data() + m_token.size()))
+      return false;
+
+    if (m_kind != k_none || m_state != s_done)
+      return error("Unexpected end of file");
+
+    m_root = m_arena.make<json_value>(std::move(m_stack.back()));
+    m_stack.clear();
+    return true;
+  }
+
+}
@@ -0,0 +1,403 @@
+/**
+ * \file json_reader.cpp
+ */
+
+#include <json_reader.h>
+#include <json_number.h>
+#include <json_scan.h>
+#include <json_string.h>
+
+#include <cstring>
+
+namespace litejson
+{
+
+  static inline bool is_alpha_num(char c)
+  {
+    return ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || (c >= '0' && c <= '9');
+  }
+
+/**********************  json_reader::json_reader  ****************/
+
+  json_reader::json_reader(std::string_view text)
+  : m_it(text.data()),
+    m_end(text.data() + text.size()),
+    m_line(1),
+    m_first(false),
+    m_max_depth(default_max_depth)
+  {
+  }
+
+/**************************  json_reader::fail  *******************/
+
+  bool json_reader::fail(const std::string& what)
+  {
+    if (!m_error.empty())
+      return false;
+
+    m_error = "Error (" + std::to_string(m_line) + ")";
+    if (!m_path.empty())
+      {
+        m_error += " at ";
+        for (const path_entry& entry : m_path)
+          {
+            m_error.push_back('/');
+            if (entry.name.data() == nullptr)
+              {
+                m_error += std::to_string(entry.index);
+                continue;
+              }
+            for (char c : entry.name)                   // Escaped as in JSON pointer
+              {
+                if (c == '~')
+                  m_error += "~0";
+                else if (c == '/')
+                  m_error += "~1";
+                else
+                  m_error.push_back(c);
+              }
+          }
+      }
+    m_error += ": " + what;
+    m_it = m_end;                                       // Nothing more is read
+    return false;
+  }
+
+/***********************  json_reader::next_char  *****************/
+
+  char json_reader::next_char()
+  {
+    m_it = skip_whitespace(m_it, m_end, &m_line);
+    return m_it != m_end ? *m_it : 0;
+  }
+
+/*************************  json_reader::peek  ********************/
+
+  json_reader::token_t json_reader::peek()
+  {
+    if (bad())
+      return tk_none;
+
+    switch (next_char())
+      {
+      case 'n': return tk_null;
+      case 't': case 'f': return tk_boolean;
+      case '\"': return tk_string;
+      case '[': return tk_array;
+      case '{': return tk_object;
+      case '-': case '0': case '1': case '2': case '3': case '4':
+      case '5': case '6': case '7': case '8': case '9': return tk_number;
+      default: return tk_none;
+      }
+  }
+
+/**********************  json_reader::read_literal  ***************/
+
+  bool json_reader::read_literal(const char* literal, size_t size)
+  {
+    if (size_t(m_end - m_it) < size || std::memcmp(m_it, literal, size) != 0 ||
+        (m_it + size != m_end && is_alpha_num(m_it[size])))
+      return false;
+
+    m_it += size;
+    return true;
+  }
+
+/************************  json_reader::read_null  ****************/
+
+  bool json_reader::read_null()
+  {
+    if (peek() != tk_null || !read_literal("null", 4))
+      return fail("null expected");
+    return true;
+  }
+
+/**************************  json_reader::read  *******************/
+
+  bool json_reader::read(bool& val)
+  {
+    if (peek() == tk_boolean)
+      {
+        if (read_literal("true", 4))
+          {
+            val = true;
+            return true;
+          }
+        if (read_literal("false", 5))
+          {
+            val = false;
+            return true;
+          }
+      }
+    return fail("boolean expected");
+  }
+
+/***********************  json_reader::read_number  ***************/
+
+  bool json_reader::read_number(json_value& num, bool* negative)
+  {
+    const char* next;
+
+    if (peek() != tk_number)
+      return false;
+
+    next = parse_number(m_it, m_end, num);
+    if (next == nullptr)
+      return false;
+
+    *negative = *m_it == '-';
+    m_it = next;
+    return true;
+  }
+
+/**************************  json_reader::read  *******************/
+
+  bool json_reader::read(double& val)
+  {
+    json_value num;
+    bool negative;
+
+    if (!read_number(num, &negative))
+      return fail("number expected");
+
+    val = num.as_double();
+    return true;
+  }
+
+/**************************  json_reader::read  *******************/
+
+  bool json_reader::read(int64_t& val)
+  {
+    json_value num;
+    bool negative;
+    uint64_t u;
+
+    if (!read_number(num, &negative))
+      return fail("integer expected");
+
+    if (!num.is_integer() && !(negative && num.as_double() == 0))  // -0 is parsed as double
+      return fail("integer expected");
+
+    if (negative)
+      {
+        val = num.as_int64();
+        return true;
+      }
+
+    u = num.as_uint64();
+    if (u > uint64_t(INT64_MAX))
+      return fail("integer out of range");
+    val = int64_t(u);
+    return true;
+  }
+
+/**************************  json_reader::read  *******************/
+
+  bool json_reader::read(uint64_t& val)
+  {
+    json_value num;
+    bool negative;
+
+    if (!read_number(num, &negative) || !num.is_integer())
+      return fail("integer expected");
+
+    if (negative)
+      return fail("integer out of range");
+    val = num.as_uint64();
+    return true;
+  }
+
+/**************************  json_reader::read  *******************/
+
+  bool json_reader::read(std::string& val)
+  {
+    const char* next;
+
+    if (peek() != tk_string)
+      return fail("string expected");
+
+    next = decode_string(m_it + 1, m_end, val);
+    if (next == nullptr)
+      return fail("bad string");
+
+    m_it = next;
+    return true;
+  }
+
+/**************************  json_reader::skip  *******************/
+
+  bool json_reader::skip()
+  {
+    std::vector<bool> open;                             // Arrays and objects inside the value, true for object
+    std::string_view name;
+    json_value num;
+    token_t tok;
+    bool negative;
+    bool b;
+
+    while (true)
+      {
+        // Scalar is consumed, array and object are only opened
+        switch (tok = peek())
+          {
+
+          case tk_null:
+            if (!read_null())
+              return false;
+            break;
+
+          case tk_boolean:
+            if (!read(b))
+              return false;
+            break;
+
+          case tk_number:
+            if (!read_number(num, &negative))
+              return fail("bad number");
+            break;
+
+          case tk_string:
+            if (!read(m_key))
+              return false;
+            break;
+
+          case tk_array:
+          case tk_object:
+            if (open.size() >= m_max_depth)
+              return fail("nesting is too deep");
+            open.push_back(tok == tk_object);
+            if (open.back())
+              begin_object();
+            else
+              begin_array();
+            break;
+
+          default:
+            return fail("value expected");
+
+          }
+
+        // Move to the next entry, close the finished arrays and objects
+        while (!open.empty() && !(open.back() ? next_member(name) : next_item()))
+          {
+            if (bad())
+              return false;
+            open.pop_back();
+          }
+
+        if (open.empty())
+          return true;
+      }
+  }
+
+/**********************  json_reader::begin_array  ****************/
+
+  bool json_reader::begin_array()
+  {
+    if (peek() != tk_array)
+      return fail("array expected");
+
+    m_it++;
+    m_first = true;
+    return true;
+  }
+
+/***********************  json_reader::next_item  *****************/
+
+  bool json_reader::next_item()
+  {
+    char c = next_char();
+    bool first = m_first;
+
+    if (bad())
+      return false;
+
+    m_first = false;
+    if (c == ']')
+      {
+        m_it++;
+        return false;
+      }
+
+    if (!first)
+      {
+        if (c != ',')
+          return fail("``,'' or ``]'' expected");
+        m_it++;
+      }
+    return true;
+  }
+
+/**********************  json_reader::begin_object  ***************/
+
+  bool json_reader::begin_object()
+  {
+    if (peek() != tk_object)
+      return fail("object expected");
+
+    m_it++;
+    m_first = true;
+    return true;
+  }
+
+/**********************  json_reader::next_member  ****************/
+
+  bool json_reader::next_member(std::string_view& name)
+  {
+    char c = next_char();
+    bool first = m_first;
+    const char* begin;
+    const char* stop;
+
+    if (bad())
+      return false;
+
+    m_first = false;
+    if (c == '}')
+      {
+        m_it++;
+        return false;
+      }
+
+    if (!first)
+      {
+        if (c != ',')
+          return fail("``,'' or ``}'' expected");
+        m_it++;
+        c = next_char();
+      }
+
+    if (c != '\"')
+      return fail("string expected");
+
+    // Names without escapes are not copied
+    begin = m_it + 1;
+    stop = scan_string(begin, m_end);
+    if (stop != m_end && *stop == '\"' && validate_utf8(begin, stop - begin))
+      {
+        name = std::string_view(begin, stop - begin);
+        m_it = stop + 1;
+      }
+    else if (!read(m_key))
+      return false;
+    else
+      name = m_key;
+
+    if (next_char() != ':')
+      return fail("``:'' expected");
+    m_it++;
+    return true;
+  }
+
+/*************************  json_reader::finish  ******************/
+
+  bool json_reader::finish()
+  {
+    if (bad())
+      return false;
+    if (next_char() != 0 || m_it != m_end)
+      return fail("``" + std::string(1, *m_it) + "'' after the end of JSON value");
+    return true;
+  }
+
+}
@@ -0,0 +1,245 @@
+/**
+ * \file json_scan.cpp
+ */
+
+#include <json_scan.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define LITEJSON_AVX2
+#endif
+
+namespace litejson
+{
+
+  const uint8_t char_class[256] =
+  {
+    0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x09, 0x09, 0x08, 0x08, 0x09, 0x08, 0x08,   // 00
+    0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,   // 10
+    0x01, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,   // 20
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,   // 30
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 40
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x08, 0x02, 0x00, 0x00,   // 50
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 60
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00,   // 70
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 80
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 90
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // A0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // B0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // C0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // D0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // E0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00   // F0
+  };
+
+/***************************  classify  ***************************/
+
+#ifdef LITEJSON_SSE2
+
+  /**
+   * Bit masks of the 64 bytes block
+   */
+  struct block_masks
+  {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t structural;
+  };
+
+  static void classify_sse2(const char* p, block_masks& m)
+  {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');              // '[' | 0x20
+    const __m128i close = _mm_set1_epi8('}');             // ']' | 0x20
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+
+    m.quote = m.backslash = m.structural = 0;
+    for (int i = 0; i < 4; i++)
+      {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        __m128i cl = _mm_or_si128(c, lower);
+        __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(cl, open), _mm_cmpeq_epi8(cl, close)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(c, colon), _mm_cmpeq_epi8(c, comma)));
+
+        m.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(c, quote)))) << (16 * i);
+        m.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(c, backslash)))) << (16 * i);
+        m.structural |= uint64_t(uint16_t(_mm_movemask_epi8(op))) << (16 * i);
+      }
+  }
+
+#ifdef LITEJSON_AVX2
+
+  __attribute__((target("avx2")))
+  static void classify_avx2(const char* p, block_masks& m)
+  {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+
+    m.quote = m.backslash = m.structural = 0;
+    for (int i = 0; i < 2; i++)
+      {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+        __m256i cl = _mm256_or_si256(c, lower);
+        __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(cl, open), _mm256_cmpeq_epi8(cl, close)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(c, colon), _mm256_cmpeq_epi8(c, comma)));
+
+        m.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, quote)))) << (32 * i);
+        m.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, backslash)))) << (32 * i);
+        m.structural |= uint64_t(uint32_t(_mm256_movemask_epi8(op))) << (32 * i);
+      }
+  }
+
+#endif
+
+  typedef void (*classify_t)(const char* p, block_masks& m);
+
+  /**
+   * Choose the widest classifier supported by the processor
+   */
+  static classify_t select_classify()
+  {
+#ifdef LITEJSON_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      return classify_avx2;
+#endif
+    return classify_sse2;
+  }
+
+#endif
+
+/************************  scan_structural  ***********************/
+
+  /**
+   * Find structural characters outside of strings. Whole 64 bytes
+   * blocks are classified by SSE2 or AVX2, the rest of the text (and
+   * the whole text without SSE2) is walked byte by byte.
+   *
+   * \param [in] data -- JSON text
+   * \param [in] size -- Size of the text
+   * \param [in] emit -- Called with offset and character of every {}[]:, outside of strings
+   * \return Return result of operation. false if string is not terminated.
+   */
+  template<class F>
+  static bool scan_structural(const char* data, size_t size, F emit)
+  {
+    size_t offset = 0;
+    bool in_string = false;
+    bool escaped = false;
+
+#ifdef LITEJSON_SSE2
+    static const classify_t classify = select_classify();
+    block_masks m;
+    uint64_t escape_carry = 0;                          // Previous block ends with escaping backslash
+    uint64_t string_carry = 0;                          // Previous block ends inside string
+
+    for (; size - offset >= 64; offset += 64)
+      {
+        const char* p = data + offset;
+
+        classify(p, m);
+
+        // Characters after odd sequences of backslashes are escaped
+        uint64_t escaped_mask = escape_carry;
+        uint64_t backslash = m.backslash & ~escape_carry;
+
+        escape_carry = 0;
+        while (backslash != 0)
+          {
+            int i = __builtin_ctzll(backslash);
+
+            if (i == 63)
+              {
+                escape_carry = 1;
+                break;
+              }
+            escaped_mask |= uint64_t(1) << (i + 1);
+            backslash &= ~(uint64_t(3) << i);
+          }
+
+        // Bits from the opening quote up to the closing quote
+        uint64_t quote = m.quote & ~escaped_mask;
+        uint64_t in_string_mask = quote;
+
+        in_string_mask ^= in_string_mask << 1;
+        in_string_mask ^= in_string_mask << 2;
+        in_string_mask ^= in_string_mask << 4;
+        in_string_mask ^= in_string_mask << 8;
+        in_string_mask ^= in_string_mask << 16;
+        in_string_mask ^= in_string_mask << 32;
+        in_string_mask ^= string_carry;
+        string_carry = uint64_t(int64_t(in_string_mask) >> 63);
+
+        for (uint64_t structural = m.structural & ~in_string_mask; structural != 0; structural &= structural - 1)
+          {
+            int i = __builtin_ctzll(structural);
+
+            emit(offset + i, p[i]);
+          }
+      }
+
+    in_string = string_carry != 0;
+    escaped = escape_carry != 0;
+#endif
+
+    for (; offset < size; offset++)
+      {
+        char c = data[offset];
+
+        if (c == '"' && !escaped)
+          in_string = !in_string;
+        else if (!in_string && is_class(c, c_structural))
+          emit(offset, c);
+        escaped = c == '\\' && !escaped;
+      }
+
+    return !in_string;
+  }
+
+/*************************  bracket_index  ************************/
+
+  bool bracket_index(const char* data, size_t size, std::vector<uint32_t>& index)
+  {
+    index.clear();
+
+    return scan_structural(data, size, [&](size_t offset, char c)
+      {
+        if ((c | 0x20) == '{' || (c | 0x20) == '}')     // Skip : and ,
+          index.push_back(uint32_t(offset));
+      });
+  }
+
+/***********************  root_separators  ************************/
+
+  bool root_separators(const char* data, size_t size, std::vector<uint32_t>& index)
+  {
+    long depth = 0;
+
+    index.clear();
+
+    return scan_structural(data, size, [&](size_t offset, char c)
+      {
+        if (c == '{' || c == '[')
+          {
+            if (++depth == 1)
+              index.push_back(uint32_t(offset));
+          }
+        else if (c == '}' || c == ']')
+          {
+            if (depth-- == 1)
+              index.push_back(uint32_t(offset));
+          }
+        else if (depth == 1)                            // , or : of the root
+          index.push_back(uint32_t(offset));
+      });
+  }
+
+}
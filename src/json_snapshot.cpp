@@ -0,0 +1,177 @@
+/**
+ * \file json_snapshot.cpp
+ */
+
+#include <json_snapshot.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace litejson
+{
+
+  /**
+   * Hazard slots of one thread. Records are shared by all holders,
+   * never deleted and reused by new threads when their thread exits.
+   */
+  struct alignas(64) hazard_record
+  {
+    std::atomic<const void*> slots[json_snapshot::max_nesting];
+    std::atomic<bool> active;
+    hazard_record* next;                                //!< Next record of the list
+  };
+
+  static std::atomic<hazard_record*> hazard_list(nullptr);
+
+  /**
+   * Take free record or add new one to the list
+   */
+  static hazard_record* acquire_record()
+  {
+    hazard_record* rec;
+    bool idle;
+
+    for (rec = hazard_list.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+      {
+        idle = false;
+        if (!rec->active.load(std::memory_order_relaxed) && rec->active.compare_exchange_strong(idle, true))
+          return rec;
+      }
+
+    rec = new hazard_record;
+    for (std::atomic<const void*>& slot : rec->slots)
+      slot.store(nullptr, std::memory_order_relaxed);
+    rec->active.store(true, std::memory_order_relaxed);
+    rec->next = hazard_list.load(std::memory_order_relaxed);
+    while (!hazard_list.compare_exchange_weak(rec->next, rec, std::memory_order_release, std::memory_order_relaxed))
+      ;
+    return rec;
+  }
+
+  /**
+   * Record of the current thread
+   */
+  struct thread_hazards
+  {
+    hazard_record* record = nullptr;
+
+    ~thread_hazards()
+    {
+      if (record != nullptr)
+        record->active.store(false, std::memory_order_release);
+    }
+  };
+
+  static thread_local thread_hazards local_hazards;
+
+/*******************  json_snapshot::json_snapshot  ***************/
+
+  json_snapshot::json_snapshot()
+  : m_current(nullptr)
+  {
+  }
+
+/******************  json_snapshot::~json_snapshot  ***************/
+
+  json_snapshot::~json_snapshot()
+  {
+    delete m_current.load();
+    for (const json_document* doc : m_retired)
+      delete doc;
+  }
+
+/***********************  json_snapshot::read  ********************/
+
+  json_snapshot::reader json_snapshot::read() const
+  {
+    hazard_record* rec = local_hazards.record;
+    std::atomic<const void*>* slot = nullptr;
+    const json_document* doc;
+    const json_document* check;
+
+    if (rec == nullptr)
+      rec = local_hazards.record = acquire_record();
+
+    for (std::atomic<const void*>& s : rec->slots)      // Slots are written by this thread only
+      if (s.load(std::memory_order_relaxed) == nullptr)
+        {
+          slot = &s;
+          break;
+        }
+
+    if (slot == nullptr)
+      throw std::runtime_error("too many nested snapshot readers");
+
+    // Announce the version, then check that it was not replaced before
+    // the announcement became visible to publish()
+    doc = m_current.load(std::memory_order_relaxed);
+    for (;;)
+      {
+        slot->store(doc, std::memory_order_seq_cst);
+        check = m_current.load(std::memory_order_seq_cst);
+        if (check == doc)
+          break;
+        doc = check;
+      }
+
+    if (doc == nullptr)
+      return reader(nullptr, nullptr);
+    return reader(doc, slot);
+  }
+
+/**********************  json_snapshot::publish  ******************/
+
+  void json_snapshot::publish(std::unique_ptr<const json_document> document)
+  {
+    const json_document* old = m_current.exchange(document.release(), std::memory_order_seq_cst);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (old != nullptr)
+      m_retired.push_back(old);
+    scan();
+  }
+
+/**********************  json_snapshot::reclaim  ******************/
+
+  void json_snapshot::reclaim()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    scan();
+  }
+
+/**********************  json_snapshot::retired  ******************/
+
+  size_t json_snapshot::retired()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_retired.size();
+  }
+
+/************************  json_snapshot::scan  *******************/
+
+  void json_snapshot::scan()
+  {
+    std::vector<const void*> hazards;
+    const void* p;
+
+    if (m_retired.empty())
+      return;
+
+    for (hazard_record* rec = hazard_list.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+      for (std::atomic<const void*>& slot : rec->slots)
+        if ((p = slot.load(std::memory_order_seq_cst)) != nullptr)
+          hazards.push_back(p);
+
+    std::sort(hazards.begin(), hazards.end());
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), [&](const json_document* doc)
+      {
+        if (std::binary_search(hazards.begin(), hazards.end(), static_cast<const void*>(doc)))
+          return false;
+        delete doc;
+        return true;
+      }), m_retired.end());
+  }
+
+}
@@ -0,0 +1,128 @@
+/**
+ * \file json_stats.cpp
+ */
+
+#include <json_stats.h>
+#include <json_value.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace litejson
+{
+
+/************************  json_stats::clear  *********************/
+
+  void json_stats::clear()
+  {
+    bytes = tokens = lazy_nodes = 0;
+    max_depth = max_array = max_object = string_bytes = 0;
+    allocations = allocated = 0;
+    keys_interned = key_bytes_saved = 0;
+    std::fill(nodes, nodes + 6, 0);
+    std::fill(time, time + ph_count, 0.0);
+  }
+
+/**********************  json_stats::count_tree  ******************/
+
+  void json_stats::count_tree(const json_value& root, size_t depth)
+  {
+    std::vector<std::pair<const json_value*, size_t>> open;    // Arrays and objects with the next entry to count
+    const json_value* container;
+    const json_value* val = &root;
+    size_t level = depth;
+    size_t size;
+    size_t i;
+
+    while (true)
+      {
+        // Count the value, array and object only open the frame
+        if (val->m_header.type & json_value::f_lazy)
+          {
+            lazy_nodes++;
+            max_depth = std::max(max_depth, level);
+          }
+        else
+          {
+            nodes[val->type()]++;
+            tokens++;
+            switch (val->type())
+              {
+
+              case json_value::t_string:
+                string_bytes += val->as_string_view().size();
+                break;
+
+              case json_value::t_array:
+                size = val->m_array.size;
+                max_depth = std::max(max_depth, level);
+                max_array = std::max(max_array, size);
+                tokens += size != 0 ? size : 1;         // Closing bracket and commas
+                open.emplace_back(val, 0);
+                break;
+
+              case json_value::t_object:
+                size = val->m_object.size;
+                max_depth = std::max(max_depth, level);
+                max_object = std::max(max_object, size);
+                tokens += size != 0 ? 3 * size : 1;     // Closing bracket, names, colons and commas
+                open.emplace_back(val, 0);
+                break;
+
+              default:
+                break;
+
+              }
+          }
+
+        // Find the next entry, close the finished arrays and objects
+        val = nullptr;
+        while (val == nullptr && !open.empty())
+          {
+            container = open.back().first;
+            i = open.back().second++;
+
+            if (container->type() == json_value::t_array && i < container->m_array.size)
+              val = &container->m_array.items[i];
+            else if (container->type() == json_value::t_object && i < container->m_object.size)
+              {
+                string_bytes += container->m_object.members[i].name.as_string_view().size();
+                val = &container->m_object.members[i].value;
+              }
+            else
+              open.pop_back();
+          }
+
+        if (val == nullptr)
+          return;
+        level = depth + open.size();
+      }
+  }
+
+/***********************  json_stats::for_each  *******************/
+
+  void json_stats::for_each(const std::function<void(const char* name, double value)>& f) const
+  {
+    static const char* node_names[] = { "nulls", "booleans", "numbers", "strings", "arrays", "objects" };
+    static const char* phase_names[] = { "time_read", "time_lexical", "time_syntax", "time_parse" };
+    size_t i;
+
+    f("bytes", bytes);
+    f("tokens", tokens);
+    for (i = 0; i < 6; i++)
+      f(node_names[i], nodes[i]);
+    f("lazy_nodes", lazy_nodes);
+    f("max_depth", max_depth);
+    f("max_array", max_array);
+    f("max_object", max_object);
+    f("string_bytes", string_bytes);
+    f("allocations", allocations);
+    f("allocated", allocated);
+    f("keys_interned", keys_interned);
+    f("key_bytes_saved", key_bytes_saved);
+    for (i = 0; i < ph_count; i++)
+      f(phase_names[i], time[i]);
+  }
+
+}
@@ -0,0 +1,279 @@
+/**
+ * \file json_stream.cpp
+ */
+
+#include <json_stream.h>
+#include <json_scan.h>
+#include <json_thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace litejson
+{
+
+/*********************  json_stream::json_stream  *****************/
+
+  json_stream::json_stream()
+  : m_data(nullptr),
+    m_size(0),
+    m_chunk_size(1024 * 1024),
+    m_offset(0),
+    m_current(0),
+    m_bad_offset(0),
+    m_badbit(false),
+    m_pool_threads(0)
+  {
+  }
+
+/**********************  json_stream::open_file  *******************/
+
+  bool json_stream::open_file(const std::string& file_name)
+  {
+    close();
+    if (!m_file.open(file_name))
+      {
+        m_badbit = true;
+        return false;
+      }
+
+    m_data = m_file.data();
+    m_size = m_file.size();
+    return true;
+  }
+
+/************************  json_stream::open  *********************/
+
+  void json_stream::open(std::string_view text)
+  {
+    close();
+    m_data = text.data();
+    m_size = text.size();
+  }
+
+/************************  json_stream::close  ********************/
+
+  void json_stream::close()
+  {
+    m_batch.loader.clear_tree();
+    m_batch.docs.clear();
+    m_batch.offsets.clear();
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_offset = 0;
+    m_current = 0;
+    m_bad_offset = 0;
+    m_badbit = false;
+  }
+
+/**********************  json_stream::chunk_end  ******************/
+
+  size_t json_stream::chunk_end(size_t offset) const
+  {
+    const char* nl;
+
+    if (m_size - offset <= m_chunk_size)
+      return m_size;
+
+    nl = static_cast<const char*>(std::memchr(m_data + offset + m_chunk_size, '\n', m_size - offset - m_chunk_size));
+    return nl != nullptr ? nl - m_data + 1 : m_size;
+  }
+
+/*********************  json_stream::parse_chunk  *****************/
+
+  void json_stream::parse_chunk(size_t begin, size_t end, batch& b) const
+  {
+    const char* p = m_data + begin;
+    const char* last = m_data + end;
+    const char* eol;
+    json_value* doc;
+    int lines = 0;
+
+    if (b.loader.key_table() != m_keys)
+      b.loader.set_key_table(m_keys);
+    b.loader.clear_tree();
+    b.docs.clear();
+    b.offsets.clear();
+    b.bad_offset = 0;
+    b.good = true;
+
+    while (p != last)
+      {
+        eol = static_cast<const char*>(std::memchr(p, '\n', last - p));
+        if (eol == nullptr)
+          eol = last;
+
+        if (skip_whitespace(p, eol, &lines) != eol)     // Blank lines are skipped
+          {
+            doc = b.loader.append_document(std::string_view(p, eol - p));
+            if (doc == nullptr)
+              {
+                b.bad_offset = p - m_data;
+                b.good = false;
+                return;
+              }
+            b.docs.push_back(doc);
+            b.offsets.push_back(p - m_data);
+          }
+
+        p = eol == last ? last : eol + 1;
+      }
+  }
+
+/************************  json_stream::next  *********************/
+
+  json_value* json_stream::next(size_t* offset)
+  {
+    size_t end;
+
+    while (m_current == m_batch.docs.size())
+      {
+        if (m_badbit || m_offset == m_size)
+          return nullptr;
+
+        end = chunk_end(m_offset);
+        parse_chunk(m_offset, end, m_batch);
+        m_badbit = !m_batch.good;
+        m_bad_offset = m_batch.bad_offset;
+        m_offset = end;
+        m_current = 0;
+      }
+
+    if (offset != nullptr)
+      *offset = m_batch.offsets[m_current];
+    return m_batch.docs[m_current++];
+  }
+
+/**********************  json_stream::for_each  *******************/
+
+  bool json_stream::for_each(const handler_t& handler, unsigned threads, order_t order)
+  {
+    std::vector<size_t> bounds;
+
+    for (size_t offset = 0; offset < m_size; offset = bounds.back())
+      {
+        if (bounds.empty())
+          bounds.push_back(0);
+        bounds.push_back(chunk_end(offset));
+      }
+    if (bounds.size() < 2)
+      return !m_badbit;
+
+    if (!m_pool || m_pool_threads != threads)
+      {
+        m_pool.reset(new json_thread_pool(threads));
+        m_pool_threads = threads;
+      }
+
+    json_thread_pool& pool = *m_pool;
+    const size_t count = bounds.size() - 1;
+    const size_t window = order == o_ordered ? 2 * pool.size() : pool.size();    // Batches in memory
+    std::mutex lock;
+    std::atomic<bool> stopped(false);                   // Handler has thrown
+    size_t first_bad = count;                           // Chunks after the bad one are skipped
+    size_t bad_offset = 0;
+    size_t next_chunk = 0;                              // Next chunk to pass to the handler
+    size_t first;
+    bool emitting = false;
+
+    while (m_batches.size() < window)
+      m_batches.emplace_back(new batch);
+    for (size_t i = 0; i < m_batches.size(); i++)
+      m_batches[i]->ready = false;                      // Left by the handler thrown in the last call
+
+    // Unordered pass: every worker parses its chunks into its own batch and passes them at once
+    if (order == o_unordered)
+      {
+        pool.run(count, [&](size_t chunk, unsigned worker)
+          {
+            batch& b = *m_batches[worker];
+            std::unique_lock<std::mutex> guard(lock);
+
+            if (stopped || chunk > first_bad)
+              return;
+            guard.unlock();
+
+            parse_chunk(bounds[chunk], bounds[chunk + 1], b);
+            try
+              {
+                for (size_t i = 0; i < b.docs.size(); i++)
+                  handler(*b.docs[i], b.offsets[i]);
+              }
+            catch (...)
+              {
+                stopped = true;
+                throw;
+              }
+
+            guard.lock();
+            if (!b.good && chunk < first_bad)
+              {
+                first_bad = chunk;
+                bad_offset = b.bad_offset;
+              }
+          });
+
+        m_badbit = first_bad != count;
+        m_bad_offset = bad_offset;
+        return !m_badbit;
+      }
+
+    // Ordered pass: chunks are parsed by rounds of window, so no more than window chunks are kept.
+    // The parsed chunks are passed in order by the thread which finds the next one ready.
+    for (first = 0; first < count && next_chunk < count && !stopped; first += window)
+      {
+        pool.run(std::min(window, count - first), [&](size_t task, unsigned)
+          {
+            size_t chunk = first + task;
+            std::unique_lock<std::mutex> guard(lock);
+
+            if (stopped || chunk > first_bad)
+              return;
+            guard.unlock();
+
+            parse_chunk(bounds[chunk], bounds[chunk + 1], *m_batches[task]);
+            guard.lock();
+
+            if (!m_batches[task]->good && chunk < first_bad)
+              {
+                first_bad = chunk;
+                bad_offset = m_batches[task]->bad_offset;
+              }
+            m_batches[task]->ready = true;
+            if (emitting)
+              return;
+
+            emitting = true;
+            try
+              {
+                while (next_chunk < count && next_chunk - first < window && m_batches[next_chunk - first]->ready)
+                  {
+                    batch& current = *m_batches[next_chunk - first];
+
+                    current.ready = false;
+                    guard.unlock();
+                    for (size_t i = 0; i < current.docs.size(); i++)
+                      handler(*current.docs[i], current.offsets[i]);
+                    guard.lock();
+
+                    next_chunk = current.good ? next_chunk + 1 : count;   // Records after the bad one are not passed
+                  }
+              }
+            catch (...)
+              {
+                stopped = true;
+                throw;
+              }
+            emitting = false;
+          });
+      }
+
+    m_badbit = first_bad != count;
+    m_bad_offset = bad_offset;
+    return !m_badbit;
+  }
+
+}
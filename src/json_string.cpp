@@ -0,0 +1,223 @@
+/**
+ * \file json_string.cpp
+ */
+
+#include <json_string.h>
+#include <json_scan.h>
+
+#include <cstdint>
+
+namespace litejson
+{
+
+/***********************  validate_sequence  **********************/
+
+  /**
+   * Validate single multibyte UTF-8 sequence
+   *
+   * \return Size of the sequence or 0 if it is not valid
+   */
+  static size_t validate_sequence(const uint8_t* p, const uint8_t* end)
+  {
+    size_t size;
+    uint32_t cp;
+    uint32_t min;
+
+    if (p[0] >= 0xC2 && p[0] <= 0xDF)
+      {
+        size = 2;
+        cp = p[0] & 0x1F;
+        min = 0x80;
+      }
+    else if (p[0] >= 0xE0 && p[0] <= 0xEF)
+      {
+        size = 3;
+        cp = p[0] & 0x0F;
+        min = 0x800;
+      }
+    else if (p[0] >= 0xF0 && p[0] <= 0xF4)
+      {
+        size = 4;
+        cp = p[0] & 0x07;
+        min = 0x10000;
+      }
+    else
+      return 0;
+
+    if (size_t(end - p) < size)
+      return 0;
+
+    for (size_t i = 1; i < size; i++)
+      {
+        if ((p[i] & 0xC0) != 0x80)
+          return 0;
+        cp = (cp << 6) | (p[i] & 0x3F);
+      }
+
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+      return 0;
+
+    return size;
+  }
+
+/*************************  validate_utf8  ************************/
+
+  bool validate_utf8(const char* text, size_t size)
+  {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(text);
+    const uint8_t* end = p + size;
+    size_t n;
+
+    while (p != end)
+      {
+#ifdef LITEJSON_SSE2
+        while (end - p >= 16)                           // Skip ASCII blocks
+          {
+            unsigned mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+
+            if (mask != 0)
+              {
+                p += __builtin_ctz(mask);
+                break;
+              }
+            p += 16;
+          }
+#endif
+
+        while (p != end && *p < 0x80)
+          p++;
+        if (p == end)
+          break;
+
+        n = validate_sequence(p, end);
+        if (n == 0)
+          return false;
+        p += n;
+      }
+
+    return true;
+  }
+
+/*************************  append_utf8  **************************/
+
+  static void append_utf8(std::string& out, uint32_t cp)
+  {
+    if (cp < 0x80)
+      out.push_back(char(cp));
+    else if (cp < 0x800)
+      {
+        out.push_back(char(0xC0 | (cp >> 6)));
+        out.push_back(char(0x80 | (cp & 0x3F)));
+      }
+    else if (cp < 0x10000)
+      {
+        out.push_back(char(0xE0 | (cp >> 12)));
+        out.push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(char(0x80 | (cp & 0x3F)));
+      }
+    else
+      {
+        out.push_back(char(0xF0 | (cp >> 18)));
+        out.push_back(char(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(char(0x80 | (cp & 0x3F)));
+      }
+  }
+
+/**************************  parse_hex4  **************************/
+
+  /**
+   * Extract four hex digits of \\u escape
+   *
+   * \return Code unit or -1 on error
+   */
+  static int32_t parse_hex4(const char* p, const char* end)
+  {
+    int32_t v = 0;
+
+    if (end - p < 4)
+      return -1;
+
+    for (int i = 0; i < 4; i++)
+      {
+        char c = p[i];
+
+        v <<= 4;
+        if (c >= '0' && c <= '9')
+          v |= c - '0';
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+          v |= (c | 0x20) - 'a' + 10;
+        else
+          return -1;
+      }
+
+    return v;
+  }
+
+/************************  decode_string  *************************/
+
+  const char* decode_string(const char* p, const char* end, std::string& out)
+  {
+    const char* stop;
+    int32_t cp;
+    int32_t low;
+
+    out.clear();
+    while (true)
+      {
+        stop = scan_string(p, end);                     // Plain part is copied at once
+        if (!validate_utf8(p, stop - p))
+          return nullptr;
+        out.append(p, stop);
+
+        if (stop == end || uint8_t(*stop) < 0x20)       // Not terminated or control character
+          return nullptr;
+        if (*stop == '"')
+          return stop + 1;
+
+        p = stop + 1;                                   // Escape sequence
+        if (p == end)
+          return nullptr;
+
+        switch (*p++)
+          {
+
+          case '"':  out.push_back('"');  break;
+          case '\\': out.push_back('\\'); break;
+          case '/':  out.push_back('/');  break;
+          case 'b':  out.push_back('\b'); break;
+          case 'f':  out.push_back('\f'); break;
+          case 'n':  out.push_back('\n'); break;
+          case 'r':  out.push_back('\r'); break;
+          case 't':  out.push_back('\t'); break;
+
+          case 'u':
+            cp = parse_hex4(p, end);
+            if (cp < 0)
+              return nullptr;
+            p += 4;
+
+            if (cp >= 0xD800 && cp <= 0xDBFF)           // High surrogate needs low one
+              {
+                if (end - p < 6 || p[0] != '\\' || p[1] != 'u')
+                  return nullptr;
+                low = parse_hex4(p + 2, end);
+                if (low < 0xDC00 || low > 0xDFFF)
+                  return nullptr;
+                p += 6;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+              }
+            else if (cp >= 0xDC00 && cp <= 0xDFFF)      // Lone low surrogate
+              return nullptr;
+
+            append_utf8(out, cp);
+            break;
+
+          default:
+            return nullptr;
+
+          }
+      }
+  }
+
+}
@@ -0,0 +1,162 @@
+/**
+ * \file json_thread_pool.cpp
+ */
+
+#include <json_thread_pool.h>
+
+namespace litejson
+{
+
+/*****************  json_thread_pool::json_thread_pool  ***********/
+
+  json_thread_pool::json_thread_pool(unsigned threads)
+  : m_task(nullptr),
+    m_generation(0),
+    m_active(0),
+    m_stop(false)
+  {
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    m_size = threads != 0 ? threads : 1;
+    m_ranges.reset(new range[m_size]);
+
+    for (unsigned i = 0; i < m_size; i++)
+      m_ranges[i].begin = m_ranges[i].end = 0;
+    for (unsigned i = 1; i < m_size; i++)
+      m_threads.emplace_back(&json_thread_pool::thread_main, this, i);
+  }
+
+/****************  json_thread_pool::~json_thread_pool  ***********/
+
+  json_thread_pool::~json_thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      m_stop = true;
+    }
+    m_start.notify_all();
+
+    for (std::thread& t : m_threads)
+      t.join();
+  }
+
+/**********************  json_thread_pool::pop  *******************/
+
+  bool json_thread_pool::pop(unsigned worker, size_t& task)
+  {
+    range& r = m_ranges[worker];
+    std::lock_guard<std::mutex> lock(r.lock);
+
+    if (r.begin == r.end)
+      return false;
+    task = r.begin++;
+    return true;
+  }
+
+/*********************  json_thread_pool::steal  ******************/
+
+  bool json_thread_pool::steal(unsigned worker, size_t& task)
+  {
+    for (unsigned i = 1; i < m_size; i++)
+      {
+        range& r = m_ranges[(worker + i) % m_size];
+        std::lock_guard<std::mutex> lock(r.lock);
+
+        if (r.begin != r.end)
+          {
+            task = --r.end;
+            return true;
+          }
+      }
+
+    return false;
+  }
+
+/**********************  json_thread_pool::work  ******************/
+
+  void json_thread_pool::work(unsigned worker)
+  {
+    size_t task;
+
+    while (pop(worker, task) || steal(worker, task))
+      {
+        try
+          {
+            (*m_task)(task, worker);
+          }
+        catch (...)
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_error)
+              m_error = std::current_exception();
+          }
+      }
+  }
+
+/*******************  json_thread_pool::thread_main  **************/
+
+  void json_thread_pool::thread_main(unsigned worker)
+  {
+    size_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+      {
+        m_start.wait(lock, [&]() { return m_stop || m_generation != generation; });
+        if (m_stop)
+          return;
+        generation = m_generation;
+
+        lock.unlock();
+        work(worker);
+        lock.lock();
+
+        if (--m_active == 0)
+          m_done.notify_all();
+      }
+  }
+
+/**********************  json_thread_pool::run  *******************/
+
+  void json_thread_pool::run(size_t count, const task_t& task)
+  {
+    std::exception_ptr error;
+
+    if (count == 0)
+      return;
+
+    for (unsigned i = 0; i < m_size; i++)
+      {
+        std::lock_guard<std::mutex> lock(m_ranges[i].lock);
+
+        m_ranges[i].begin = count * i / m_size;
+        m_ranges[i].end = count * (i + 1) / m_size;
+      }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      m_task = &task;
+      m_active = m_size - 1;
+      m_generation++;
+    }
+    m_start.notify_all();
+
+    work(0);
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_done.wait(lock, [&]() { return m_active == 0; });
+      m_task = nullptr;
+      error = m_error;
+      m_error = nullptr;
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+}
@@ -3,194 +3,270 @@
  */
 
 #include <json_value.h>
+#include <json_pointer.h>
+#include <json_lazy.h>
 
 #include <stdexcept>
-#include <cmath>
+#include <cstring>
+#include <new>
 
 namespace litejson
 {
 
-/*******************  json_value::json_value  *******************/
-
-  json_value::json_value()
-  : m_value_type(t_null),
-    m_data_smartptr(nullptr, [&](void* p)
-    {
-      switch (m_value_type)
-        {
-
-        case t_string:
-          delete reinterpret_cast<std::string*>(p);
-          break;
+  /**
+   * Compare member name with the key. Keys of the intern table are
+   * the same characters, so they match without comparing them.
+   */
+  static inline bool same_key(std::string_view name, std::string_view key)
+  {
+    return name.size() == key.size() && (name.data() == key.data() || std::memcmp(name.data(), key.data(), key.size()) == 0);
+  }
 
-        case t_boolean:
-          delete reinterpret_cast<bool*>(p);
-          break;
+/********************  json_value::type_error  ******************/
 
-        case t_number:
-          delete reinterpret_cast<float*>(p);
-          break;
+  void json_value::type_error(const char* what)
+  {
+    throw std::runtime_error(what);
+  }
 
-        case t_array:
-          for (auto it : *(reinterpret_cast<value_array_t*>(p)))
-            delete it;
-          delete reinterpret_cast<value_array_t*>(p);
-          break;
+/**********************  json_value::expand  ********************/
 
-        case t_object:
-          for (auto it : *(reinterpret_cast<value_object_t*>(p)))
-            delete it.second;
-          delete reinterpret_cast<value_object_t*>(p);
-          break;
+  void json_value::expand() const
+  {
+    m_lazy.document->materialize(const_cast<json_value&>(*this));
+  }
 
-        default:
-          break;
+/*********************  json_value::release  ********************/
 
-        }
-    })
+  void json_value::release()
   {
-    //ctor
-  }
+    std::vector<json_value> pending;                    // Owned arrays and objects, their entries are not released yet
+    json_value node;
+    size_t i;
 
-/*******************  json_value::json_value  *******************/
+    // Owned containers of the entries are moved to the list, so deep trees do not recurse
+    auto detach = [&](json_value& val)
+      {
+        if ((val.m_header.type & f_owned) && (val.type() == t_array || val.type() == t_object))
+          pending.push_back(std::move(val));
+      };
 
-  json_value::json_value(float f)
-  : m_value_type(t_number),
-    m_data_smartptr(new float(f), [&](void* p)
-    {
-      switch (m_value_type)
-        {
+    auto free_storage = [&](json_value& val)
+      {
+        switch (val.type())
+          {
 
-        case t_string:
-          delete reinterpret_cast<std::string*>(p);
-          break;
+          case t_string:
+            delete[] val.m_string.chars;
+            break;
 
-        case t_boolean:
-          delete reinterpret_cast<bool*>(p);
-          break;
+          case t_array:
+            for (i = 0; i < val.m_array.size; i++)
+              {
+                detach(val.m_array.items[i]);
+                val.m_array.items[i].~json_value();
+              }
+            ::operator delete(val.m_array.items);
+            break;
 
-        case t_number:
-          delete reinterpret_cast<float*>(p);
-          break;
+          case t_object:
+            for (i = 0; i < val.m_object.size; i++)
+              {
+                detach(val.m_object.members[i].value);
+                val.m_object.members[i].~json_member();
+              }
+            ::operator delete(val.m_object.members);
+            break;
 
-        case t_array:
-          for (auto it : *(reinterpret_cast<value_array_t*>(p)))
-            delete it;
-          delete reinterpret_cast<value_array_t*>(p);
-          break;
+          default:
+            break;
 
-        case t_object:
-          for (auto it : *(reinterpret_cast<value_object_t*>(p)))
-            delete it.second;
-          delete reinterpret_cast<value_object_t*>(p);
-          break;
+          }
 
-        default:
-          break;
+        val.reset();
+      };
 
-        }
-    })
-  {
-    // ctor
+    free_storage(*this);
+    while (!pending.empty())
+      {
+        node.m_string = pending.back().m_string;
+        pending.back().reset();
+        pending.pop_back();
+        free_storage(node);
+      }
   }
 
-/*******************  json_value::json_value  *******************/
+/******************  json_value::release_owned  *****************/
 
-  json_value::json_value(bool b)
-  : m_value_type(t_boolean),
-    m_data_smartptr(new bool(b), [&](void* p)
-    {
-      switch (m_value_type)
-        {
+  void json_value::release_owned()
+  {
+    std::vector<json_value*> containers;                // Containers to visit
+    std::vector<json_value*> owned;                     // Owned containers, parents first
+    json_value* node;
+    size_t i;
 
-        case t_string:
-          delete reinterpret_cast<std::string*>(p);
-          break;
+    // Owned storage may hold arena containers with owned storage below, so all containers are visited
+    auto visit = [&](json_value& val)
+      {
+        if (val.type() == t_string)
+          {
+            if (val.m_header.type & f_owned)
+              val.release();
+          }
+        else if ((val.type() == t_array || val.type() == t_object) && !(val.m_header.type & f_lazy))
+          {
+            if (val.m_header.type & f_owned)
+              owned.push_back(&val);
+            if (val.m_array.size != 0)
+              containers.push_back(&val);
+          }
+      };
 
-        case t_boolean:
-          delete reinterpret_cast<bool*>(p);
-          break;
+    visit(*this);
+    while (!containers.empty())
+      {
+        node = containers.back();
+        containers.pop_back();
+        if (node->type() == t_array)
+          for (i = 0; i < node->m_array.size; i++)
+            visit(node->m_array.items[i]);
+        else
+          for (i = 0; i < node->m_object.size; i++)
+            {
+              visit(node->m_object.members[i].name);
+              visit(node->m_object.members[i].value);
+            }
+      }
 
-        case t_number:
-          delete reinterpret_cast<float*>(p);
-          break;
+    for (i = owned.size(); i != 0; i--)                 // Entries are released before their container
+      owned[i - 1]->release();
+  }
 
-        case t_array:
-          for (auto it : *(reinterpret_cast<value_array_t*>(p)))
-            delete it;
-          delete reinterpret_cast<value_array_t*>(p);
-          break;
+/********************  json_value::set_string  ******************/
 
-        case t_object:
-          for (auto it : *(reinterpret_cast<value_object_t*>(p)))
-            delete it.second;
-          delete reinterpret_cast<value_object_t*>(p);
-          break;
+  void json_value::set_string(const char* str, size_t len, json_arena* arena)
+  {
+    char* chars;
 
-        default:
-          break;
+    reset();
+    if (len <= short_string_max)
+      {
+        m_short.type = t_string | f_short;
+        m_short.size = len;
+        std::memcpy(m_short.chars, str, len);
+        return;
+      }
 
-        }
-    })
-  {
-    // ctor
-  }
+    if (arena != nullptr)
+      chars = static_cast<char*>(arena->allocate(len + 1, 1));
+    else
+      chars = new char[len + 1];
 
-/*******************  json_value::json_value  *******************/
+    std::memcpy(chars, str, len);
+    chars[len] = 0;
 
-  json_value::json_value(const std::string& str)
-  : m_value_type(t_string),
-    m_data_smartptr(new std::string(str), [&](void* p)
-    {
-      switch (m_value_type)
-        {
+    m_string.type = arena != nullptr ? t_string : t_string | f_owned;
+    m_string.size = len;
+    m_string.chars = chars;
+  }
 
-        case t_string:
-          delete reinterpret_cast<std::string*>(p);
-          break;
+/*********************  json_value::copy_from  ******************/
 
-        case t_boolean:
-          delete reinterpret_cast<bool*>(p);
-          break;
+  void json_value::copy_from(const json_value& other)
+  {
+    std::vector<std::pair<json_value*, const json_value*>> pending;   // Copies of arrays and objects, their entries are not copied yet
+    json_value* to;
+    const json_value* from;
+    size_t i;
 
-        case t_number:
-          delete reinterpret_cast<float*>(p);
-          break;
+    // Scalars and strings are copied at once, arrays and objects only get their storage
+    auto copy_node = [&](json_value& dst, const json_value& src)
+      {
+        dst.reset();
+        if (src.m_header.type & f_lazy)
+          src.expand();
 
-        case t_array:
-          for (auto it : *(reinterpret_cast<value_array_t*>(p)))
-            delete it;
-          delete reinterpret_cast<value_array_t*>(p);
-          break;
+        switch (src.type())
+          {
 
-        case t_object:
-          for (auto it : *(reinterpret_cast<value_object_t*>(p)))
-            delete it.second;
-          delete reinterpret_cast<value_object_t*>(p);
-          break;
+          case t_string:
+            if (src.m_header.type & f_short)
+              dst.m_short = src.m_short;
+            else
+              dst.set_string(src.m_string.chars, src.m_string.size, nullptr);
+            break;
+
+          case t_array:
+            dst.make_array();
+            if (src.m_array.size == 0)
+              break;
+            dst.m_array.items = static_cast<json_value*>(::operator new(src.m_array.size * sizeof(json_value)));
+            dst.m_array.capacity = 0;
+            pending.emplace_back(&dst, &src);
+            break;
+
+          case t_object:
+            dst.make_object();
+            if (src.m_object.size == 0)
+              break;
+            dst.m_object.members = allocate_members(src.m_object.size, nullptr);
+            dst.m_object.capacity = 0;
+            pending.emplace_back(&dst, &src);
+            break;
+
+          default:
+            dst.m_scalar = src.m_scalar;
+            break;
 
-        default:
-          break;
+          }
+      };
 
-        }
-    })
-  {
-    // ctor
-  }
+    copy_node(*this, other);
+    while (!pending.empty())
+      {
+        to = pending.back().first;
+        from = pending.back().second;
+        pending.pop_back();
 
-/*******************  json_value::~json_value  ******************/
+        if (from->type() == t_array)
+          {
+            for (i = 0; i < from->m_array.size; i++)
+              {
+                new (to->m_array.items + i) json_value();
+                to->m_array.size = i + 1;
+                copy_node(to->m_array.items[i], from->m_array.items[i]);
+              }
+            continue;
+          }
 
-  json_value::~json_value()
-  {
-    // dtor
+        for (i = 0; i < from->m_object.size; i++)
+          {
+            new (to->m_object.members + i) json_member();
+            to->m_object.size = i + 1;
+            copy_node(to->m_object.members[i].name, from->m_object.members[i].name);
+            copy_node(to->m_object.members[i].value, from->m_object.members[i].value);
+          }
+        if (to->m_object.size >= index_min)
+          {
+            to->m_object.type |= f_indexed;
+            to->build_index();
+          }
+      }
   }
 
 /*******************  json_value::json_value  *******************/
 
   json_value::json_value(const json_value& other)
-  : m_value_type(other.m_value_type)
   {
-    m_data_smartptr = other.m_data_smartptr;
+    try
+      {
+        copy_from(other);
+      }
+    catch (...)                                         // Destructor is not called, the part copied so far is released here
+      {
+        release();
+        throw;
+      }
   }
 
 /********************  json_value::operator=  *******************/
@@ -198,153 +274,151 @@ namespace litejson
   json_value& json_value::operator=(const json_value& other)
   {
     if (this == &other) return *this; // handle self assignment
-    
-    m_data_smartptr = other.m_data_smartptr;
-    m_value_type = other.m_value_type;
-    return *this;
-  }
 
-/*********************  json_value::is_null  ********************/
+    json_value tmp(other);
 
-  bool json_value::is_null() const
-  {
-    return m_value_type == t_null;
+    return *this = std::move(tmp);
   }
 
-/********************  json_value::is_boolean  ******************/
+/********************  json_value::operator=  *******************/
 
-  bool json_value::is_boolean() const
+  json_value& json_value::operator=(json_value&& other) noexcept
   {
-    return m_value_type == t_boolean;
-  }
+    if (this == &other) return *this; // handle self assignment
 
-/********************  json_value::is_number  *******************/
+    json_value tmp(std::move(other));                   // Other may be an entry of this value, so it is taken before the release
 
-  bool json_value::is_number() const
-  {
-    return m_value_type == t_number;
+    if (m_header.type & f_owned)
+      release();
+    m_string = tmp.m_string;
+    tmp.reset();
+    return *this;
   }
 
-/********************  json_value::is_string  *******************/
+/*******************  json_value::find_member  ******************/
 
-  bool json_value::is_string() const
+  json_value* json_value::find_member(std::string_view key) const
   {
-    return m_value_type == t_string;
-  }
-
-/*********************  json_value::is_array  *******************/
+    for (size_t i = m_object.size; i != 0; i--)         // Last duplicate wins
+      {
+        if (same_key(m_object.members[i - 1].name.as_string_view(), key))
+          return &m_object.members[i - 1].value;
+      }
 
-  bool json_value::is_array() const
-  {
-    return m_value_type == t_array;
+    return nullptr;
   }
 
-/********************  json_value::is_object  *******************/
+/*******************  json_value::find_member  ******************/
 
-  bool json_value::is_object() const
+  json_value* json_value::find_member(std::string_view key, uint32_t key_hash) const
   {
-    return m_value_type == t_object;
-  }
-
-/********************  json_value::as_string  *******************/
+    const index_slot* slots = index();
+    size_t mask = index_size(capacity()) - 1;
 
-  const std::string& json_value::as_string()
-  {
-    if (m_value_type != t_string)
+    for (size_t i = key_hash & mask; slots[i].position != 0; i = (i + 1) & mask)
       {
-        throw std::runtime_error("is not a string");
-      }
-    else
-      {
-        return *(std::static_pointer_cast<std::string>(m_data_smartptr));
+        json_member& member = m_object.members[slots[i].position - 1];
+
+        if (slots[i].hash == key_hash && same_key(member.name.as_string_view(), key))
+          return &member.value;
       }
+
+    return nullptr;
   }
 
-/********************  json_value::as_integer  ******************/
+/*****************  json_value::allocate_members  ***************/
 
-  int json_value::as_integer()
+  json_member* json_value::allocate_members(size_t capacity, json_arena* arena)
   {
-    if (m_value_type != t_number)
-      {
-        throw std::runtime_error("is not a number");
-      }
-    else
-      {
-        return nearbyint(*(std::static_pointer_cast<float>(m_data_smartptr)));
-      }
-  }
+    size_t size = capacity * sizeof(json_member);
 
-/*********************  json_value::as_float  *******************/
+    if (capacity >= index_min)
+      size += index_size(capacity) * sizeof(index_slot);
 
-  float json_value::as_float()
-  {
-    if (m_value_type != t_number)
-      {
-        throw std::runtime_error("is not a number");
-      }
-    else
-      {
-        return *(std::static_pointer_cast<float>(m_data_smartptr));
-      }
+    if (arena != nullptr)
+      return static_cast<json_member*>(arena->allocate(size, alignof(json_member)));
+    return static_cast<json_member*>(::operator new(size));
   }
 
-/********************  json_value::as_boolean  ******************/
+/*******************  json_value::index_insert  *****************/
 
-  bool json_value::as_boolean()
+  void json_value::index_insert(uint32_t hash, uint32_t position)
   {
-    if (m_value_type != t_boolean)
-      {
-        throw std::runtime_error("is not a boolean");
-      }
-    else
+    index_slot* slots = index();
+    size_t mask = index_size(capacity()) - 1;
+    std::string_view key = m_object.members[position].name.as_string_view();
+    size_t i;
+
+    for (i = hash & mask; slots[i].position != 0; i = (i + 1) & mask)
       {
-        return *(std::static_pointer_cast<bool>(m_data_smartptr));
+        if (slots[i].hash == hash && same_key(m_object.members[slots[i].position - 1].name.as_string_view(), key))
+          break;
       }
+
+    slots[i].hash = hash;
+    slots[i].position = position + 1;
   }
 
-/*********************  json_value::as_array  *******************/
+/*******************  json_value::build_index  ******************/
 
-  json_value* json_value::as_array(int index)
+  void json_value::build_index()
   {
-    if (m_value_type != t_array)
-      {
-        throw std::runtime_error("is not an array");
-      }
-    else
-      {
-        if (index < std::static_pointer_cast<value_array_t>(m_data_smartptr)->size())
-          return std::static_pointer_cast<value_array_t>(m_data_smartptr)->at(index);
-        else
-          return nullptr;
-      }
+    std::memset(index(), 0, index_size(capacity()) * sizeof(index_slot));
+    for (uint32_t i = 0; i < m_object.size; i++)
+      index_insert(hash(m_object.members[i].name.as_string_view()), i);
   }
 
-/********************  json_value::as_object  *******************/
+/*******************  json_value::at_pointer  *******************/
 
-  json_value* json_value::as_object(const std::string& key)
+  const json_value* json_value::at_pointer(std::string_view pointer) const
   {
-    if (m_value_type != t_object)
-      {
-        throw std::runtime_error("is not an object");
-      }
-    else
+    const json_value* node = this;
+    std::string_view token;
+    std::string name;
+    size_t next;
+    int64_t index;
+
+    if (!pointer.empty() && pointer[0] != '/')
+      type_error("is not a JSON pointer");
+
+    while (!pointer.empty())
       {
-        auto it = std::static_pointer_cast<value_object_t>(m_data_smartptr)->find(key);
-        if (it != std::static_pointer_cast<value_object_t>(m_data_smartptr)->end())
-          return it->second;
+        pointer.remove_prefix(1);                       // Skip '/'
+        next = pointer.find('/');
+        token = pointer.substr(0, next);
+        pointer = next == std::string_view::npos ? std::string_view() : pointer.substr(next);
+
+        if (token.find('~') != std::string_view::npos)  // Escaped names are rare
+          {
+            if (!json_pointer::unescape(token, name))
+              type_error("is not a JSON pointer");
+            token = name;
+          }
+
+        if (node->is_object())
+          node = node->as_object(token);
+        else if (node->is_array() && (index = json_pointer::array_index(token)) >= 0 && index <= INT32_MAX)
+          node = node->as_array(int(index));
         else
           return nullptr;
+
+        if (node == nullptr)
+          return nullptr;
       }
+
+    return node;
   }
 
 /**********************  json_value::print  *********************/
 
-  void json_value::print(std::ostream& stream)
+  void json_value::print(std::ostream& stream) const
   {
-    int sz;
-    value_object_t::const_iterator it;
+    size_t i;
+
+    if (m_header.type & f_lazy)
+      expand();
 
-    switch (m_value_type)
+    switch (type())
       {
 
       case t_null:
@@ -356,42 +430,38 @@ namespace litejson
         break;
 
       case t_number:
-        stream << as_float();
+        if (m_scalar.aux == n_int64)
+          stream << m_scalar.int64;
+        else if (m_scalar.aux == n_uint64)
+          stream << m_scalar.uint64;
+        else
+          stream << m_scalar.number;
         break;
 
       case t_string:
-        stream << "\"" << as_string() << "\"";
+        stream << "\"" << as_string_view() << "\"";
         break;
 
       case t_array:
         stream << "[" << std::endl;
-        sz = std::static_pointer_cast<value_array_t>(m_data_smartptr)->size();
-        if (sz != 0)
+        for (i = 0; i < m_array.size; i++)
           {
-            for (int i = 0; i < sz; i++)
-              {
-                as_array(i)->print(stream);
-                if (i != sz - 1)
-                  stream << "," << std::endl;
-                else
-                  stream << std::endl;
-              }
+            m_array.items[i].print(stream);
+            if (i != m_array.size - 1)
+              stream << "," << std::endl;
+            else
+              stream << std::endl;
           }
         stream << "]" << std::endl;
         break;
 
       case t_object:
         stream << "{" << std::endl;
-        sz = std::static_pointer_cast<value_object_t>(m_data_smartptr)->size();
-        if (sz != 0)
+        for (i = 0; i < m_object.size; i++)
           {
-            for (it = std::static_pointer_cast<value_object_t>(m_data_smartptr)->begin();
-                 it != std::static_pointer_cast<value_object_t>(m_data_smartptr)->end(); it++)
-              {
-                stream << "\"" << it->first << "\" : ";
-                it->second->print(stream);
-                stream << "," << std::endl;
-              }
+            stream << "\"" << m_object.members[i].name.as_string_view() << "\" : ";
+            m_object.members[i].value.print(stream);
+            stream << "," << std::endl;
           }
         stream << "}" << std::endl;
         break;
@@ -399,40 +469,208 @@ namespace litejson
       }
   }
 
-/*****************  json_value::add_array_entry  ****************/
+/********************  json_value::make_array  ******************/
 
-  void json_value::add_array_entry(json_value* val)
+  void json_value::make_array()
+  {
+    if (m_header.type & f_owned)
+      release();
+    reset();
+    m_array.type = t_array | f_owned;
+    m_array.items = nullptr;
+  }
+
+/*******************  json_value::make_object  ******************/
+
+  void json_value::make_object()
   {
-    if (m_value_type == t_null)
+    if (m_header.type & f_owned)
+      release();
+    reset();
+    m_object.type = t_object | f_owned;
+    m_object.members = nullptr;
+  }
+
+/***********************  json_value::grow  *********************/
+
+  void json_value::grow(size_t count)
+  {
+    size_t i;
+    size_t size = m_array.size;
+    uint8_t capacity = 2;                               // At least 4 entries
+
+    while ((size_t(1) << capacity) < count)
+      capacity++;
+
+    if (type() == t_array)
       {
-        m_data_smartptr = std::make_shared<value_array_t>();
+        json_value* items = static_cast<json_value*>(::operator new((size_t(1) << capacity) * sizeof(json_value)));
+
+        for (i = 0; i < size; i++)
+          {
+            new (items + i) json_value(std::move(m_array.items[i]));
+            m_array.items[i].~json_value();
+          }
+        if (m_header.type & f_owned)
+          ::operator delete(m_array.items);
+        m_array.items = items;
+      }
+    else
+      {
+        json_member* members = allocate_members(size_t(1) << capacity, nullptr);
+
+        for (i = 0; i < size; i++)
+          {
+            new (members + i) json_member(std::move(m_object.members[i]));
+            m_object.members[i].~json_member();
+          }
+        if (m_header.type & f_owned)
+          ::operator delete(m_object.members);
+        m_object.members = members;
       }
-    else if (m_value_type != t_array)
+
+    m_array.type |= f_owned;
+    m_array.capacity = capacity;
+
+    if (type() == t_object && (size_t(1) << capacity) >= index_min)
       {
-        m_data_smartptr = nullptr;
-        m_data_smartptr = std::make_shared<value_array_t>();
+        m_object.type |= f_indexed;
+        build_index();
       }
-    
-    m_value_type = t_array;
-    std::static_pointer_cast<value_array_t>(m_data_smartptr)->push_back(val);
+  }
+
+/*********************  json_value::reserve  ********************/
+
+  void json_value::reserve(size_t count)
+  {
+    if (type() != t_array && type() != t_object)
+      type_error("is not an array or object");
+    if (m_header.type & f_lazy)
+      expand();
+
+    if (count > capacity() || (!(m_header.type & f_owned) && count > m_array.size))
+      grow(count);
+  }
+
+/*******************  json_value::reserve_item  *****************/
+
+  json_value* json_value::reserve_item()
+  {
+    if (type() != t_array)
+      make_array();
+    else if (m_header.type & f_lazy)
+      expand();
+
+    if (m_array.size == capacity() || !(m_header.type & f_owned))
+      grow(m_array.size + 1);
+
+    return m_array.items + m_array.size;
+  }
+
+/******************  json_value::reserve_member  ****************/
+
+  json_member* json_value::reserve_member()
+  {
+    if (type() != t_object)
+      make_object();
+    else if (m_header.type & f_lazy)
+      expand();
+
+    if (m_object.size == capacity() || !(m_header.type & f_owned))
+      grow(m_object.size + 1);
+
+    return m_object.members + m_object.size;
+  }
+
+/******************  json_value::commit_member  *****************/
+
+  void json_value::commit_member(std::string_view key)
+  {
+    if (m_header.type & f_indexed)
+      index_insert(hash(key), m_object.size);
+    m_object.size++;
+  }
+
+/*****************  json_value::add_array_entry  ****************/
+
+  void json_value::add_array_entry(json_value* val)
+  {
+    emplace_array_entry(std::move(*val));
+    delete val;
   }
 
 /*****************  json_value::add_object_entry  ***************/
 
-  void json_value::add_object_entry(const std::string& key, json_value* val)
+  void json_value::add_object_entry(std::string_view key, json_value* val)
   {
-    if (m_value_type == t_null)
-      {
-        m_data_smartptr = std::make_shared<value_object_t>();
-      }
-    else if (m_value_type != t_object)
+    emplace_object_entry(key, std::move(*val));
+    delete val;
+  }
+
+/*****************  json_value::add_object_entry  ***************/
+
+  json_value& json_value::add_object_entry(json_member&& member)
+  {
+    json_value* old;
+    json_member* entry;
+
+    if (!member.name.is_string())
+      type_error("key is not a string");
+
+    old = type() == t_object ? as_object(member.name.as_string_view()) : nullptr;
+    if (old != nullptr)
+      return *old = std::move(member.value);
+
+    entry = reserve_member();
+    new (entry) json_member(std::move(member));
+    commit_member(entry->name.as_string_view());
+    return entry->value;
+  }
+
+/*******************  json_value::assign_array  *****************/
+
+  void json_value::assign_array(json_value* items, size_t count, json_arena& arena)
+  {
+    json_value* storage = nullptr;
+
+    if (count != 0)
+      storage = static_cast<json_value*>(arena.allocate(count * sizeof(json_value), alignof(json_value)));
+
+    for (size_t i = 0; i < count; i++)
+      new (storage + i) json_value(std::move(items[i]));
+
+    if (m_header.type & f_owned)
+      release();
+    reset();
+    m_array.type = t_array;
+    m_array.size = count;
+    m_array.items = storage;
+  }
+
+/******************  json_value::assign_object  *****************/
+
+  void json_value::assign_object(json_value* pairs, size_t count, json_arena& arena)
+  {
+    json_member* storage = nullptr;
+
+    if (count != 0)
+      storage = allocate_members(count, &arena);
+
+    for (size_t i = 0; i < count; i++)
+      new (storage + i) json_member{std::move(pairs[2 * i]), std::move(pairs[2 * i + 1])};
+
+    if (m_header.type & f_owned)
+      release();
+    reset();
+    m_object.type = t_object;
+    m_object.size = count;
+    m_object.members = storage;
+
+    if (count >= index_min)
       {
-        m_data_smartptr = nullptr;
-        m_data_smartptr = std::make_shared<value_object_t>();
+        m_object.type |= f_indexed;
+        build_index();
       }
-    
-    m_value_type = t_object;
-    (*std::static_pointer_cast<value_object_t>(m_data_smartptr))[key] = val;
   }
 
 }
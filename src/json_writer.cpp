@@ -0,0 +1,405 @@
+/**
+ * \file json_writer.cpp
+ */
+
+#include <json_writer.h>
+#include <json_scan.h>
+
+#include <charconv>
+#include <cmath>
+
+namespace litejson
+{
+
+/*********************  json_writer::json_writer  *****************/
+
+  json_writer::json_writer(int indent)
+  : m_indent(indent),
+    m_after_key(false)
+  {
+  }
+
+/*********************  json_writer::json_writer  *****************/
+
+  json_writer::json_writer(sink_t sink, int indent)
+  : m_sink(std::move(sink)),
+    m_indent(indent),
+    m_after_key(false)
+  {
+    m_buffer.reserve(sink_threshold + 4096);
+  }
+
+/********************  json_writer::~json_writer  *****************/
+
+  json_writer::~json_writer()
+  {
+    // The sink may throw, so the rest of the text is passed by flush() only
+  }
+
+/************************  json_writer::flush  ********************/
+
+  void json_writer::flush()
+  {
+    if (m_sink && !m_buffer.empty())
+      {
+        m_sink(m_buffer);
+        m_buffer.clear();
+      }
+  }
+
+/************************  json_writer::write  ********************/
+
+  void json_writer::write(const json_value& val)
+  {
+    begin_value();
+    write_value(val, m_entries.size());
+  }
+
+/*********************  json_writer::begin_value  *****************/
+
+  void json_writer::begin_value()
+  {
+    if (m_after_key)
+      {
+        m_after_key = false;
+        return;
+      }
+
+    if (m_entries.empty())
+      return;
+
+    if (m_entries.back()++ != 0)
+      m_buffer.push_back(',');
+    if (m_indent != 0)
+      write_newline(m_entries.size());
+  }
+
+/********************  json_writer::end_container  ****************/
+
+  void json_writer::end_container(char bracket)
+  {
+    uint32_t entries = m_entries.back();
+
+    m_entries.pop_back();
+    if (m_indent != 0 && entries != 0)
+      write_newline(m_entries.size());
+    m_buffer.push_back(bracket);
+    flush_full();
+  }
+
+/*********************  json_writer::begin_array  *****************/
+
+  void json_writer::begin_array()
+  {
+    begin_value();
+    m_buffer.push_back('[');
+    m_entries.push_back(0);
+    flush_full();
+  }
+
+/**********************  json_writer::end_array  ******************/
+
+  void json_writer::end_array()
+  {
+    end_container(']');
+  }
+
+/*********************  json_writer::begin_object  ****************/
+
+  void json_writer::begin_object()
+  {
+    begin_value();
+    m_buffer.push_back('{');
+    m_entries.push_back(0);
+    flush_full();
+  }
+
+/**********************  json_writer::end_object  *****************/
+
+  void json_writer::end_object()
+  {
+    end_container('}');
+  }
+
+/*************************  json_writer::key  *********************/
+
+  void json_writer::key(std::string_view name)
+  {
+    begin_value();
+    write_string(name);
+    if (m_indent != 0)
+      m_buffer.append(": ", 2);
+    else
+      m_buffer.push_back(':');
+    m_after_key = true;
+    flush_full();
+  }
+
+/************************  json_writer::value  ********************/
+
+  void json_writer::value(bool val)
+  {
+    begin_value();
+    if (val)
+      m_buffer.append("true", 4);
+    else
+      m_buffer.append("false", 5);
+    flush_full();
+  }
+
+/************************  json_writer::value  ********************/
+
+  void json_writer::value(long long val)
+  {
+    begin_value();
+    write_integer(int64_t(val));
+    flush_full();
+  }
+
+/************************  json_writer::value  ********************/
+
+  void json_writer::value(unsigned long long val)
+  {
+    begin_value();
+    write_integer(uint64_t(val));
+    flush_full();
+  }
+
+/************************  json_writer::value  ********************/
+
+  void json_writer::value(double val)
+  {
+    begin_value();
+    write_double(val);
+    flush_full();
+  }
+
+/************************  json_writer::value  ********************/
+
+  void json_writer::value(float val)
+  {
+    begin_value();
+    write_float(val);
+    flush_full();
+  }
+
+/************************  json_writer::value  ********************/
+
+  void json_writer::value(std::string_view val)
+  {
+    begin_value();
+    write_string(val);
+    flush_full();
+  }
+
+/**********************  json_writer::null_value  *****************/
+
+  void json_writer::null_value()
+  {
+    begin_value();
+    m_buffer.append("null", 4);
+    flush_full();
+  }
+
+/**********************  json_writer::to_string  ******************/
+
+  std::string json_writer::to_string(const json_value& val, int indent)
+  {
+    json_writer writer(indent);
+
+    writer.write(val);
+    return std::move(writer.m_buffer);
+  }
+
+/*********************  json_writer::write_newline  ***************/
+
+  void json_writer::write_newline(int depth)
+  {
+    m_buffer.push_back('\n');
+    m_buffer.append(size_t(depth) * m_indent, ' ');
+  }
+
+/*********************  json_writer::write_string  ****************/
+
+  void json_writer::write_string(std::string_view str)
+  {
+    static const char hex[] = "0123456789abcdef";
+    const char* p = str.data();
+    const char* end = p + str.size();
+    const char* stop;
+
+    m_buffer.push_back('\"');
+    while (true)
+      {
+        stop = scan_string(p, end);                     // Plain part is copied at once
+        m_buffer.append(p, stop);
+        if (stop == end)
+          break;
+
+        switch (*stop)
+          {
+          case '\"': m_buffer.append("\\\"", 2); break;
+          case '\\': m_buffer.append("\\\\", 2); break;
+          case '\b': m_buffer.append("\\b", 2); break;
+          case '\f': m_buffer.append("\\f", 2); break;
+          case '\n': m_buffer.append("\\n", 2); break;
+          case '\r': m_buffer.append("\\r", 2); break;
+          case '\t': m_buffer.append("\\t", 2); break;
+          default:
+            m_buffer.append("\\u00", 4);
+            m_buffer.push_back(hex[uint8_t(*stop) >> 4]);
+            m_buffer.push_back(hex[uint8_t(*stop) & 0x0F]);
+            break;
+          }
+        p = stop + 1;
+      }
+    m_buffer.push_back('\"');
+  }
+
+/*********************  json_writer::write_number  ****************/
+
+  void json_writer::write_number(const json_value& val)
+  {
+    if (val.m_scalar.aux == json_value::n_int64)
+      write_integer(val.m_scalar.int64);
+    else if (val.m_scalar.aux == json_value::n_uint64)
+      write_integer(val.m_scalar.uint64);
+    else
+      write_double(val.m_scalar.number);
+  }
+
+/*********************  json_writer::write_integer  ***************/
+
+  void json_writer::write_integer(int64_t i)
+  {
+    char buf[24];
+
+    m_buffer.append(buf, std::to_chars(buf, buf + sizeof(buf), i).ptr);
+  }
+
+/*********************  json_writer::write_integer  ***************/
+
+  void json_writer::write_integer(uint64_t u)
+  {
+    char buf[24];
+
+    m_buffer.append(buf, std::to_chars(buf, buf + sizeof(buf), u).ptr);
+  }
+
+/*********************  json_writer::write_double  ****************/
+
+  void json_writer::write_double(double d)
+  {
+    char buf[32];
+
+    if (!std::isfinite(d))
+      m_buffer.append("null", 4);
+    else
+      m_buffer.append(buf, std::to_chars(buf, buf + sizeof(buf), d).ptr);  // Shortest round trip
+  }
+
+/*********************  json_writer::write_float  *****************/
+
+  void json_writer::write_float(float f)
+  {
+    char buf[32];
+
+    if (!std::isfinite(f))
+      m_buffer.append("null", 4);
+    else
+      m_buffer.append(buf, std::to_chars(buf, buf + sizeof(buf), f).ptr);  // Shortest round trip of float
+  }
+
+/*********************  json_writer::write_value  *****************/
+
+  void json_writer::write_value(const json_value& root, int depth)
+  {
+    const json_value* val = &root;
+    size_t size;
+    bool object;
+
+    m_frames.clear();
+    while (true)
+      {
+        if (val->m_header.type & json_value::f_lazy)
+          val->expand();
+
+        // Scalar is written, array and object only open the frame
+        switch (val->type())
+          {
+
+          case json_value::t_null:
+            m_buffer.append("null", 4);
+            break;
+
+          case json_value::t_boolean:
+            if (val->m_scalar.boolean)
+              m_buffer.append("true", 4);
+            else
+              m_buffer.append("false", 5);
+            break;
+
+          case json_value::t_number:
+            write_number(*val);
+            break;
+
+          case json_value::t_string:
+            write_string(val->as_string_view());
+            break;
+
+          case json_value::t_array:
+            m_buffer.push_back('[');
+            m_frames.push_back(frame{val, 0});
+            break;
+
+          case json_value::t_object:
+            m_buffer.push_back('{');
+            m_frames.push_back(frame{val, 0});
+            break;
+
+          }
+
+        flush_full();                                   // Large documents go to the sink by parts
+
+        // Find the next entry, close the finished arrays and objects
+        val = nullptr;
+        while (val == nullptr && !m_frames.empty())
+          {
+            frame& f = m_frames.back();
+
+            object = f.container->type() == json_value::t_object;
+            size = object ? f.container->m_object.size : f.container->m_array.size;
+            if (f.next == size)
+              {
+                m_frames.pop_back();
+                if (m_indent != 0 && size != 0)
+                  write_newline(depth + m_frames.size());
+                m_buffer.push_back(object ? '}' : ']');
+                flush_full();
+                continue;
+              }
+
+            if (f.next != 0)
+              m_buffer.push_back(',');
+            if (m_indent != 0)
+              write_newline(depth + m_frames.size());
+            if (object)
+              {
+                write_string(f.container->m_object.members[f.next].name.as_string_view());
+                if (m_indent != 0)
+                  m_buffer.append(": ", 2);
+                else
+                  m_buffer.push_back(':');
+                val = &f.container->m_object.members[f.next].value;
+              }
+            else
+              val = &f.container->m_array.items[f.next];
+            f.next++;
+          }
+
+        if (val == nullptr)
+          return;
+      }
+  }
+
+}
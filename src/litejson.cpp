@@ -3,52 +3,267 @@
  */
 
 #include <litejson.h>
+#include <json_mapped_file.h>
+#include <json_number.h>
+#include <json_scan.h>
+#include <json_string.h>
+#include <json_thread_pool.h>
 
 #include <iostream>
-#include <cctype>
+#include <algorithm>
+#include <atomic>
 
 namespace litejson
 {
 
+  static inline bool is_alpha(char c)
+  {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+  }
+
 /*******************  json_loader::json_loader  *******************/
 
   json_loader::json_loader()
   : m_root(nullptr),
-    m_badbit(false)
+    m_badbit(false),
+    m_log(&std::cerr),
+    m_max_depth(default_max_depth),
+    m_zero_copy(false),
+    m_keys_interned(0),
+    m_key_bytes_saved(0),
+    m_threads(0)
   {
-    // TODO : Constructor
   }
 
 
+/******************  json_loader::~json_loader  ******************/
+
+  json_loader::~json_loader()
+  {
+    clear_tree();
+  }
+
 /*******************  json_loader::json_loader  *******************/
 
-  json_loader::json_loader(const std::string& file_name)
+  json_loader::json_loader(const std::string& file_name, parse_mode_t mode)
   : m_root(nullptr),
-    m_badbit(false)
+    m_badbit(false),
+    m_log(&std::cerr),
+    m_max_depth(default_max_depth),
+    m_zero_copy(false),
+    m_keys_interned(0),
+    m_key_bytes_saved(0),
+    m_threads(0)
+  {
+    load_file(file_name, mode);
+  }
+
+/*******************  json_loader::json_loader  *******************/
+
+  json_loader::json_loader(const char* data, size_t size, parse_mode_t mode)
+  : m_root(nullptr),
+    m_badbit(false),
+    m_log(&std::cerr),
+    m_max_depth(default_max_depth),
+    m_zero_copy(false),
+    m_keys_interned(0),
+    m_key_bytes_saved(0),
+    m_threads(0)
+  {
+    load(std::string_view(data, size), mode);
+  }
+
+/**********************  json_loader::load  ***********************/
+
+  bool json_loader::load(std::string_view text, parse_mode_t mode)
+  {
+    time_point start;
+
+    clear_tree();
+    m_badbit = false;
+    start = start_stats(text.size());
+
+    if (mode == pm_lazy)                                // Text of the caller may go away
+      {
+        m_text.assign(text);
+        text = m_text;
+        start = lap(json_stats::ph_read, start);
+      }
+
+    m_badbit = !parse(text.data(), text.data() + text.size(), mode, start);
+    finish_stats();
+    return !m_badbit;
+  }
+
+/*****************  json_loader::append_document  ****************/
+
+  json_value* json_loader::append_document(std::string_view text)
+  {
+    m_badbit = !parse_text(text.data(), text.data() + text.size());
+    if (m_badbit)
+      return nullptr;
+    return m_root;
+  }
+
+/********************  json_loader::load_file  ********************/
+
+  bool json_loader::load_file(const std::string& file_name, parse_mode_t mode)
   {
+    json_mapped_file file;
+    json_mapped_file& text = mode == pm_lazy || m_zero_copy ? m_file : file;    // Tree refers to the text
+    time_point start;
     int line;
 
+    clear_tree();
+    m_badbit = false;
+    start = start_stats(0);
+
+    if (mode != pm_two_pass)
+      {
+        if (!text.open(file_name))
+          {
+            m_badbit = true;
+            return false;
+          }
+
+        if (m_stats)
+          m_stats->bytes = text.size();
+        start = lap(json_stats::ph_read, start);
+        m_badbit = !parse(text.data(), text.data() + text.size(), mode, start);
+        finish_stats();
+        return !m_badbit;
+      }
+
     std::ifstream ifs(file_name);
 
     if (!ifs)
       {
         m_badbit = true;
-        return;
+        return false;
       }
 
+    m_tokens.clear();
+
     // Lexical analysis
     if (!lexical(ifs, &line))
       {
-        std::cerr << "Lexical error(" << line << ")" << std::endl;
-        std::cerr.flush();
+        *m_log << "Lexical error(" << line << ")" << std::endl;
+        m_log->flush();
         m_badbit = true;
-        return;
+        return false;
       }
 
-    if (!syntax(&line))
+    if (m_stats)
       {
-        m_badbit = true;
-        return;
+        ifs.clear();
+        m_stats->bytes = ifs.tellg();
+      }
+    start = lap(json_stats::ph_lexical, start);
+    m_badbit = !syntax();
+    m_tokens.clear();
+    lap(json_stats::ph_syntax, start);
+    finish_stats();
+    return !m_badbit;
+  }
+
+/**********************  json_loader::parse  **********************/
+
+  bool json_loader::parse(const char* begin, const char* end, parse_mode_t mode, time_point start)
+  {
+    bool result;
+    int line;
+
+    switch (mode)
+      {
+
+      case pm_single_pass:
+        result = parse_text(begin, end);
+        break;
+
+      case pm_parallel:
+        result = parse_parallel(begin, end);
+        break;
+
+      case pm_lazy:
+        result = open_lazy(begin, end);
+        break;
+
+      default:
+        m_tokens.clear();
+
+        // Lexical analysis
+        if (!lexical(begin, end, &line))
+          {
+            *m_log << "Lexical error(" << line << ")" << std::endl;
+            return false;
+          }
+
+        start = lap(json_stats::ph_lexical, start);
+        result = syntax();
+        m_tokens.clear();
+        lap(json_stats::ph_syntax, start);
+        return result;
+
+      }
+
+    lap(json_stats::ph_parse, start);
+    return result;
+  }
+
+/******************  json_loader::enable_stats  *******************/
+
+  void json_loader::enable_stats(bool enable)
+  {
+    if (enable)
+      m_stats.reset(new json_stats());
+    else
+      m_stats.reset();
+  }
+
+/*******************  json_loader::start_stats  *******************/
+
+  json_loader::time_point json_loader::start_stats(size_t bytes)
+  {
+    if (!m_stats)
+      return time_point();
+
+    m_stats->clear();
+    m_stats->bytes = bytes;
+    return std::chrono::steady_clock::now();
+  }
+
+/***********************  json_loader::lap  ***********************/
+
+  json_loader::time_point json_loader::lap(json_stats::phase_t phase, time_point start)
+  {
+    time_point now;
+
+    if (!m_stats)
+      return start;
+
+    now = std::chrono::steady_clock::now();
+    m_stats->time[phase] += std::chrono::duration<double>(now - start).count();
+    return now;
+  }
+
+/******************  json_loader::finish_stats  *******************/
+
+  void json_loader::finish_stats()
+  {
+    if (!m_stats || m_root == nullptr)
+      return;
+
+    m_stats->count_tree(*m_root);
+    m_stats->allocations = m_arena.block_count();
+    m_stats->allocated = m_arena.bytes_reserved();
+    m_stats->keys_interned = m_keys_interned;
+    m_stats->key_bytes_saved = m_key_bytes_saved;
+    for (const std::unique_ptr<json_loader>& worker : m_workers)
+      {
+        m_stats->allocations += worker->m_arena.block_count();
+        m_stats->allocated += worker->m_arena.bytes_reserved();
+        m_stats->keys_interned += worker->m_keys_interned;
+        m_stats->key_bytes_saved += worker->m_key_bytes_saved;
       }
   }
 
@@ -60,7 +275,7 @@ namespace litejson
 
     *n = 0;
 
-    while (!std::getline(stream, str).eof())
+    while (std::getline(stream, str))                   // Last line may have no new line
       {
         (*n)++;
         if (!parse_string(str, *n))
@@ -70,6 +285,28 @@ namespace litejson
     return true;
   }
 
+/*********************  json_loader::lexical  *********************/
+
+  bool json_loader::lexical(const char* begin, const char* end, int* n)
+  {
+    std::string str;
+    const char* eol;
+
+    *n = 0;
+
+    while (begin != end)
+      {
+        eol = std::find(begin, end, '\n');
+        str.assign(begin, eol);
+        (*n)++;
+        if (!parse_string(str, *n))
+          return false;
+        begin = (eol == end) ? end : eol + 1;
+      }
+
+    return true;
+  }
+
 /*******************  json_loader::parse_string  ******************/
 
   bool json_loader::parse_string(std::string& str, int n)
@@ -82,20 +319,14 @@ namespace litejson
         str_token.clear();
         if (*it == '\"')                            // String
           {
-            it++;
-            while (*it != '\"')
-              {
-                if (*it == 0)
-                  return false;
-                else
-                  str_token.push_back(*it);
-                it++;
-              }
-            it++;
+            const char* next = decode_string(&*it + 1, str.data() + str.size(), str_token);
+
+            if (next == nullptr)
+              return false;
+            it += next - &*it;
             m_tokens.emplace_back(token::tok_string, str_token, n);
-            // TODO : Extract coded characters
           }
-        else if (*it == '-' || std::isdigit(*it))   // Numeric
+        else if (*it == '-' || is_class(*it, c_digit))   // Numeric
           {
             if (*it == '-')                         // Extract mantissa sign
               {
@@ -103,9 +334,9 @@ namespace litejson
                 it++;
               }
 
-            if (!std::isdigit(*it))                      // Extract mantissa integer part
+            if (!is_class(*it, c_digit))                      // Extract mantissa integer part
               return false;
-            while (std::isdigit(*it))
+            while (is_class(*it, c_digit))
               {
                 str_token.push_back(*it);
                 it++;
@@ -116,10 +347,10 @@ namespace litejson
                 str_token.push_back(*it);
                 it++;
 
-                if (!std::isdigit(*it))                  // Extract fractional part
+                if (!is_class(*it, c_digit))                  // Extract fractional part
                   return false;
                 
-                while (std::isdigit(*it))
+                while (is_class(*it, c_digit))
                   {
                     str_token.push_back(*it);
                     it++;
@@ -137,10 +368,10 @@ namespace litejson
                     it++;
                   }
 
-                if (!std::isdigit(*it))                  // Extract exponent part
+                if (!is_class(*it, c_digit))                  // Extract exponent part
                   return false;
 
-                while (std::isdigit(*it))
+                while (is_class(*it, c_digit))
                   {
                     str_token.push_back(*it);
                     it++;
@@ -160,9 +391,9 @@ namespace litejson
             m_tokens.emplace_back(token::tok_operator, str_token, n);
             it++;
           }
-        else if (std::isalpha(*it))                 // null, false, true
+        else if (is_alpha(*it))                     // null, false, true
           {
-            while (std::isalpha(*it))
+            while (is_alpha(*it))
               {
                 str_token.push_back(*it);
                 it++;
@@ -183,9 +414,9 @@ namespace litejson
             else
               return false;
           }
-        else if (isspace(*it))
+        else if (is_class(*it, c_space))
           {
-            it++;
+            it += skip_whitespace(&*it, str.data() + str.size(), &n) - &*it;
           }
         else if (*it == 0)
           {
@@ -200,171 +431,575 @@ namespace litejson
 
 /**********************  json_loader::syntax  *********************/
 
-  bool json_loader::syntax(int* n)
+  bool json_loader::syntax()
   {
     int index = 0;
 
-    m_root = parse_node(&index);
+    m_stack.clear();
+    if (!parse_node(&index))
+      return false;
 
-    return m_root != nullptr;
+    set_root();
+    return true;
   }
 
 /********************  json_loader::parse_node  *******************/
 
-  json_value* json_loader::parse_node(int* index)
+  bool json_loader::parse_node(int* index)
   {
-    std::string name;
-    json_value* val;
-    json_value* local_val;
+    int count = m_tokens.size();
+    const token* tok;
+    bool object;
 
-    if (*index >= m_tokens.size())
-      return nullptr;
-
-    switch (m_tokens[*index].type)
+    m_frames.clear();
+    while (true)
       {
+        if (*index >= count)
+          {
+            *m_log << "Syntax error (" << (count != 0 ? m_tokens.back().line : 1) << "): Unexpected end of file" << std::endl;
+            return false;
+          }
 
-      case token::tok_operator:
-        if (m_tokens[*index].text[0] == '{')                    // Object
+        // Get value, array and object only open the frame
+        tok = &m_tokens[*index];
+        if (tok->type == token::tok_operator && (tok->text[0] == '{' || tok->text[0] == '['))
           {
-            val = new json_value();
+            object = tok->text[0] == '{';
+            if (!push_frame(object, tok->line))
+              return false;
             (*index)++;
-            while (true)
+
+            tok = *index < count ? &m_tokens[*index] : nullptr;
+            if (tok == nullptr || tok->type != token::tok_operator || tok->text[0] != (object ? '}' : ']'))
               {
-                // Get name
-                if (m_tokens[*index].type != token::tok_string)
-                  {
-                    std::cerr << "Syntax error (" << m_tokens[*index].line << "): String expected" << std::endl;
-                    delete val;
-                    return nullptr;
-                  }
+                if (object && !parse_key(index))
+                  return false;
+                continue;
+              }
+            (*index)++;                                 // Empty array or object
+            pop_frame();
+          }
+        else if (!parse_scalar(index))
+          return false;
+
+        // Close the finished arrays and objects
+        while (!m_frames.empty())
+          {
+            object = m_frames.back().object;
+            tok = *index < count ? &m_tokens[*index] : nullptr;
+            if (tok == nullptr)
+              {
+                *m_log << "Syntax error (" << m_tokens.back().line << "): Unexpected end of file" << std::endl;
+                return false;
+              }
 
-                name = m_tokens[*index].text;
+            if (tok->type == token::tok_operator && tok->text[0] == ',')
+              {
                 (*index)++;
+                if (object && !parse_key(index))
+                  return false;
+                break;
+              }
+            else if (tok->type == token::tok_operator && tok->text[0] == (object ? '}' : ']'))
+              {
+                (*index)++;
+                pop_frame();
+              }
+            else
+              {
+                *m_log << "Syntax error (" << tok->line << "): ``"
+                          << tok->text << "\'\' is not allowed here" << std::endl;
+                return false;
+              }
+          }
 
-                // Get :
-                if (m_tokens[*index].type != token::tok_operator || m_tokens[*index].text[0] != ':')
-                  {
-                    std::cerr << "Syntax error (" << m_tokens[*index].line << "): ``:\'\' expected" << std::endl;
-                    delete val;
-                    return nullptr;
-                  }
+        if (m_frames.empty())
+          return true;
+      }
+  }
 
-                (*index)++;
+/********************  json_loader::parse_key  ********************/
 
-                // Get value
-                local_val = parse_node(index);
-                if (local_val == nullptr)
-                  {
-                    delete val;
-                    return nullptr;
-                  }
+  bool json_loader::parse_key(int* index)
+  {
+    int count = m_tokens.size();
 
-                val->add_object_entry(name, local_val);
+    // Get name
+    if (*index >= count || m_tokens[*index].type != token::tok_string)
+      {
+        *m_log << "Syntax error (" << m_tokens[std::min(*index, count - 1)].line << "): String expected" << std::endl;
+        return false;
+      }
 
-                if (m_tokens[*index].type == token::tok_operator)
-                  {
-                    if (m_tokens[*index].text[0] == ',')
-                      {
-                        (*index)++;
-                        continue;
-                      }
-                    else if (m_tokens[*index].text[0] == '}')
-                      {
-                        (*index)++;
-                        break;
-                      }
-                    else
-                      {
-                        std::cerr << "Syntax error (" << m_tokens[*index].line << "): ``"
-                                  << m_tokens[*index].text << "\'\' is not allowed here" << std::endl;
-                        delete val;
-                        return nullptr;
-                      }
-                  }
-                else
-                  {
-                    std::cerr << "Syntax error (" << m_tokens[*index].line << "): ``"
-                              << m_tokens[*index].text << "\'\' is not allowed here" << std::endl;
-                    delete val;
-                    return nullptr;
-                  }
+    if (m_keys && m_tokens[*index].text.size() > json_value::short_string_max)
+      m_stack.push_back(intern_key(m_tokens[*index].text, true));
+    else
+      m_stack.emplace_back(m_tokens[*index].text, m_arena);
+    (*index)++;
+
+    // Get :
+    if (*index >= count || m_tokens[*index].type != token::tok_operator || m_tokens[*index].text[0] != ':')
+      {
+        *m_log << "Syntax error (" << m_tokens[std::min(*index, count - 1)].line << "): ``:\'\' expected" << std::endl;
+        return false;
+      }
+
+    (*index)++;
+    return true;
+  }
+
+/*******************  json_loader::parse_scalar  ******************/
+
+  bool json_loader::parse_scalar(int* index)
+  {
+    const token& tok = m_tokens[*index];
+
+    switch (tok.type)
+      {
+
+      case token::tok_null:                                     // Null
+        (*index)++;
+        m_stack.emplace_back();
+        return true;
+
+      case token::tok_boolean:                                  // Boolean
+        (*index)++;
+        m_stack.emplace_back(tok.text == "true");
+        return true;
+
+      case token::tok_string:                                   // String
+        (*index)++;
+        m_stack.emplace_back(tok.text, m_arena);
+        return true;
+
+      case token::tok_number:                                   // Number
+        (*index)++;
+        m_stack.emplace_back();
+        return parse_number(tok.text.data(), tok.text.data() + tok.text.size(), m_stack.back()) != nullptr;
+
+      default:
+        *m_log << "Syntax error (" << tok.line << "): ``"
+                  << tok.text << "\'\' is not allowed here" << std::endl;
+        return false;
+
+      }
+  }
+
+/********************  json_loader::push_frame  *******************/
+
+  bool json_loader::push_frame(bool object, int line)
+  {
+    if (m_frames.size() >= m_max_depth)
+      {
+        *m_log << "Syntax error (" << line << "): Nesting is too deep" << std::endl;
+        return false;
+      }
+
+    m_frames.push_back(frame{m_stack.size(), object});
+    return true;
+  }
+
+/********************  json_loader::pop_frame  ********************/
+
+  void json_loader::pop_frame()
+  {
+    frame f = m_frames.back();
+
+    m_frames.pop_back();
+    if (f.object)
+      end_object(f.base);
+    else
+      end_array(f.base);
+  }
+
+/*********************  json_loader::end_array  *******************/
+
+  void json_loader::end_array(size_t base)
+  {
+    json_value val;
+
+    val.assign_array(m_stack.data() + base, m_stack.size() - base, m_arena);
+    m_stack.resize(base);
+    m_stack.push_back(std::move(val));
+  }
+
+/********************  json_loader::end_object  *******************/
+
+  void json_loader::end_object(size_t base)
+  {
+    json_value val;
+
+    val.assign_object(m_stack.data() + base, (m_stack.size() - base) / 2, m_arena);
+    m_stack.resize(base);
+    m_stack.push_back(std::move(val));
+  }
+
+/********************  json_loader::set_root  *********************/
+
+  void json_loader::set_root()
+  {
+    m_root = m_arena.make<json_value>(std::move(m_stack.back()));
+    m_documents.push_back(m_root);
+    m_stack.clear();
+  }
+
+
+/*******************  json_loader::parse_text  ********************/
+
+  bool json_loader::parse_text(const char* begin, const char* end)
+  {
+    cursor c = { begin, end, 1 };
+
+    m_stack.clear();
+    if (!parse_value(c))
+      return false;
+
+    skip_space(c);
+    if (c.it != c.end)
+      {
+        *m_log << "Syntax error (" << c.line << "): ``" << *c.it
+                  << "\'\' after the end of JSON value" << std::endl;
+        return false;
+      }
+
+    set_root();
+    return true;
+  }
+
+/*****************  json_loader::parse_parallel  *****************/
+
+  bool json_loader::parse_parallel(const char* begin, const char* end)
+  {
+    std::vector<uint32_t> seps;
+    std::vector<json_value> entries;
+    size_t size = end - begin;
+    size_t count;
+    size_t tasks;
+    bool object;
+    int lines = 0;
+
+    if (size < parallel_min || size > UINT32_MAX || !root_separators(begin, size, seps) || seps.size() < 3)
+      return parse_text(begin, end);
+
+    // Root must be the only value, entries must be separated by , (and : in objects)
+    object = begin[seps.front()] == '{';
+    if (skip_whitespace(begin, end, &lines) != begin + seps.front() ||
+        skip_whitespace(begin + seps.back() + 1, end, &lines) != end ||
+        begin[seps.back()] != begin[seps.front()] + 2 ||
+        (object && seps.size() % 2 != 1))
+      return parse_text(begin, end);
+
+    for (size_t i = 1; i + 1 < seps.size(); i++)
+      if (begin[seps[i]] != (object && i % 2 == 1 ? ':' : ','))
+        return parse_text(begin, end);
+
+    // Every span between the separators is single value, name or value of the object entry
+    count = seps.size() - 1;
+    entries.resize(count);
+
+    std::atomic<bool> failed(false);
+
+    if (!m_pool)
+      m_pool.reset(new json_thread_pool(m_threads));
+
+    json_thread_pool& pool = *m_pool;
+
+    while (m_workers.size() < pool.size())
+      {
+        m_workers.emplace_back(new json_loader());
+        m_workers.back()->m_null_log.reset(new std::ostream(nullptr));    // Messages are dropped, every worker writes its own stream
+        m_workers.back()->m_log = m_workers.back()->m_null_log.get();
+      }
+    for (std::unique_ptr<json_loader>& worker : m_workers)
+      {
+        worker->m_max_depth = m_max_depth != 0 ? m_max_depth - 1 : 0;     // Entries are one level below the root
+        worker->m_zero_copy = m_zero_copy;
+        worker->m_keys = m_keys;
+      }
+
+    tasks = std::min(count, size_t(pool.size()) * 16);
+    pool.run(tasks, [&](size_t task, unsigned worker)
+      {
+        json_loader& loader = *m_workers[worker];
+        json_value* val;
+
+        for (size_t i = count * task / tasks; i < count * (task + 1) / tasks && !failed; i++)
+          {
+            val = loader.append_document(std::string_view(begin + seps[i] + 1, seps[i + 1] - seps[i] - 1));
+            if (val == nullptr || (object && i % 2 == 0 && !val->is_string()))
+              {
+                failed = true;
+                break;
+              }
+            if (object && i % 2 == 0 && m_keys && val->as_string_view().size() > json_value::short_string_max)
+              {
+                std::string_view key = val->as_string_view();
+
+                // Name refers to the text or to the arena of the worker, as the serial parser it is taken from the table
+                entries[i] = loader.intern_key(key, key.data() < begin || key.data() >= end);
+                continue;
               }
-            return val;
+            entries[i] = std::move(*val);
+          }
+      });
+
+    if (failed)                                         // Errors are reported by the serial parser
+      {
+        m_workers.clear();
+        return parse_text(begin, end);
+      }
+
+    m_stack.clear();
+    m_stack.emplace_back();
+    if (object)
+      m_stack.back().assign_object(entries.data(), count / 2, m_arena);
+    else
+      m_stack.back().assign_array(entries.data(), count, m_arena);
+    set_root();
+    return true;
+  }
+
+/********************  json_loader::open_lazy  ********************/
+
+  bool json_loader::open_lazy(const char* begin, const char* end)
+  {
+    json_value root;
+
+    m_lazy.set_max_depth(m_max_depth);
+    if (!m_lazy.open(begin, end - begin, m_arena, root))
+      {
+        if (m_lazy.too_deep())
+          *m_log << "Syntax error: Nesting is too deep" << std::endl;
+        else
+          *m_log << "Syntax error: brackets or quotes do not match" << std::endl;
+        return false;
+      }
+
+    m_root = m_arena.make<json_value>(std::move(root));
+    m_documents.push_back(m_root);
+    return true;
+  }
+
+/*******************  json_loader::skip_space  ********************/
+
+  void json_loader::skip_space(cursor& c)
+  {
+    c.it = skip_whitespace(c.it, c.end, &c.line);
+  }
+
+/*******************  json_loader::read_string  *******************/
+
+  bool json_loader::read_string(cursor& c, std::string& str)
+  {
+    const char* next = decode_string(c.it + 1, c.end, str);
+
+    if (next == nullptr)
+      {
+        *m_log << "Lexical error(" << c.line << ")" << std::endl;
+        return false;
+      }
+
+    c.it = next;
+    return true;
+  }
+
+/*******************  json_loader::push_string  *******************/
+
+  bool json_loader::push_string(cursor& c, bool key)
+  {
+    const char* begin = c.it + 1;
+    const char* stop = scan_string(begin, c.end);
+    std::string_view str;
+
+    if (stop != c.end && *stop == '\"' && validate_utf8(begin, stop - begin))
+      {
+        str = std::string_view(begin, stop - begin);
+        c.it = stop + 1;
+        if (key && m_keys && str.size() > json_value::short_string_max)
+          m_stack.push_back(intern_key(str, !m_zero_copy));
+        else if (m_zero_copy)
+          m_stack.emplace_back(str, json_value::view);
+        else
+          m_stack.emplace_back(str, m_arena);
+        return true;
+      }
+
+    if (!read_string(c, m_scratch))                     // Escapes are decoded
+      return false;
+    if (key && m_keys && m_scratch.size() > json_value::short_string_max)
+      m_stack.push_back(intern_key(m_scratch, true));
+    else
+      m_stack.emplace_back(m_scratch, m_arena);
+    return true;
+  }
+
+/********************  json_loader::intern_key  *******************/
+
+  json_value json_loader::intern_key(std::string_view key, bool copied)
+  {
+    bool added;
+    std::string_view stored = m_keys->intern(key, &added);
+
+    if (stored.data() == nullptr)                       // Table is full, the key is copied as without it
+      return json_value(key, m_arena);
+
+    m_keys_interned++;
+    if (!added && copied)
+      m_key_bytes_saved += key.size() + 1;
+    return json_value(stored, json_value::view);
+  }
+
+/*******************  json_loader::parse_value  *******************/
+
+  bool json_loader::parse_value(cursor& c)
+  {
+    bool object;
+
+    m_frames.clear();
+    while (true)
+      {
+        skip_space(c);
+        if (c.it == c.end)
+          {
+            *m_log << "Syntax error (" << c.line << "): Unexpected end of file" << std::endl;
+            return false;
           }
-        else if (m_tokens[*index].text[0] == '[')               // Array
+
+        // Get value, array and object only open the frame
+        if (*c.it == '{' || *c.it == '[')
           {
-            val = new json_value();
-            (*index)++;
+            object = *c.it == '{';
+            if (!push_frame(object, c.line))
+              return false;
+            c.it++;
 
-            while (true)
+            skip_space(c);
+            if (c.it == c.end || *c.it != (object ? '}' : ']'))
               {
-                local_val = parse_node(index);
-                if (local_val == nullptr)
-                  {
-                    delete val;
-                    return nullptr;
-                  }
-
-                val->add_array_entry(local_val);
+                if (object && !parse_key(c))
+                  return false;
+                continue;
+              }
+            c.it++;                                     // Empty array or object
+            pop_frame();
+          }
+        else if (!parse_scalar(c))
+          return false;
 
-                if (m_tokens[*index].type == token::tok_operator)
-                  {
-                    if (m_tokens[*index].text[0] == ',')
-                      {
-                        (*index)++;
-                        continue;
-                      }
-                    else if (m_tokens[*index].text[0] == ']')
-                      {
-                        (*index)++;
-                        break;
-                      }
-                    else
-                      {
-                        std::cerr << "Syntax error (" << m_tokens[*index].line << "): ``"
-                                  << m_tokens[*index].text << "\'\' is not allowed here" << std::endl;
-                        delete val;
-                        return nullptr;
-                      }
-                  }
-                else
-                  {
-                    std::cerr << "Syntax error (" << m_tokens[*index].line << "): ``"
-                              << m_tokens[*index].text << "\'\' is not allowed here" << std::endl;
-                    delete val;
-                    return nullptr;
-                  }
+        // Close the finished arrays and objects
+        while (!m_frames.empty())
+          {
+            object = m_frames.back().object;
+            skip_space(c);
+            if (c.it != c.end && *c.it == ',')
+              {
+                c.it++;
+                if (object && !parse_key(c))
+                  return false;
+                break;
+              }
+            else if (c.it != c.end && *c.it == (object ? '}' : ']'))
+              {
+                c.it++;
+                pop_frame();
+              }
+            else if (object)
+              {
+                *m_log << "Syntax error (" << c.line << "): ``,\'\' or ``}\'\' expected" << std::endl;
+                return false;
+              }
+            else
+              {
+                *m_log << "Syntax error (" << c.line << "): ``,\'\' or ``]\'\' expected" << std::endl;
+                return false;
               }
           }
-        else
+
+        if (m_frames.empty())
+          return true;
+      }
+  }
+
+/********************  json_loader::parse_key  ********************/
+
+  bool json_loader::parse_key(cursor& c)
+  {
+    // Get name
+    skip_space(c);
+    if (c.it == c.end || *c.it != '\"')
+      {
+        *m_log << "Syntax error (" << c.line << "): String expected" << std::endl;
+        return false;
+      }
+
+    if (!push_string(c, true))
+      return false;
+
+    // Get :
+    skip_space(c);
+    if (c.it == c.end || *c.it != ':')
+      {
+        *m_log << "Syntax error (" << c.line << "): ``:\'\' expected" << std::endl;
+        return false;
+      }
+    c.it++;
+    return true;
+  }
+
+/*******************  json_loader::parse_scalar  ******************/
+
+  bool json_loader::parse_scalar(cursor& c)
+  {
+    const char* next;
+
+    switch (*c.it)
+      {
+
+      case '\"':                                        // String
+        return push_string(c, false);
+
+      case 'n':                                         // Null
+        if (c.end - c.it >= 4 && std::equal(c.it, c.it + 4, "null"))
           {
-            std::cerr << "Syntax error (" << m_tokens[*index].line << "): ``"
-                      << m_tokens[*index].text << "\'\' is not allowed here" << std::endl;
-            return nullptr;
+            c.it += 4;
+            m_stack.emplace_back();
+            return true;
           }
-        return val;
         break;
 
-      case token::tok_null:                                     // Null
-        (*index)++;
-        return new json_value();
+      case 't':                                         // Boolean
+        if (c.end - c.it >= 4 && std::equal(c.it, c.it + 4, "true"))
+          {
+            c.it += 4;
+            m_stack.emplace_back(true);
+            return true;
+          }
         break;
 
-      case token::tok_boolean:                                  // Boolean
-        (*index)++;
-        return new json_value(m_tokens[*index - 1].text == "true");
+      case 'f':
+        if (c.end - c.it >= 5 && std::equal(c.it, c.it + 5, "false"))
+          {
+            c.it += 5;
+            m_stack.emplace_back(false);
+            return true;
+          }
         break;
 
-      case token::tok_string:                                   // String
-        (*index)++;
-        return new json_value(m_tokens[*index - 1].text);
-        break;
+      default:                                          // Number
+        m_stack.emplace_back();
+        next = parse_number(c.it, c.end, m_stack.back());
+        if (next == nullptr)
+          {
+            m_stack.pop_back();
+            break;
+          }
+        c.it = next;
+        return true;
 
-      case token::tok_number:                                   // Number
-        (*index)++;
-        return new json_value((float)std::atof(m_tokens[*index - 1].text.c_str()));
-        break;
       }
+
+    *m_log << "Lexical error(" << c.line << ")" << std::endl;
+    return false;
   }
 
 /***********************  json_loader::bad  ***********************/
@@ -392,10 +1027,26 @@ namespace litejson
 
   void json_loader::clear_tree()
   {
-    if (m_root != nullptr)
-      delete m_root;
-
+    for (json_value* doc : m_documents)                 // Nodes of the workers are released too
+      doc->release_owned();
+    m_documents.clear();
     m_root = nullptr;
+    m_stack.clear();
+    m_arena.clear();
+    m_lazy.close();
+    m_file.close();
+    m_text.clear();
+    m_workers.clear();
+    m_keys_interned = 0;
+    m_key_bytes_saved = 0;
+  }
+
+/******************  json_loader::set_key_table  ******************/
+
+  void json_loader::set_key_table(std::shared_ptr<json_key_table> table)
+  {
+    clear_tree();                                       // Keys of the tree may be in the old table
+    m_keys = std::move(table);
   }
 
 }
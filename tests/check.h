@@ -0,0 +1,24 @@
+/**
+ * \file check.h
+ * Check of the tests. Failed check prints its line and makes main()
+ * return -1.
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+
+#define CHECK(x)                                                  \
+  do                                                              \
+    {                                                             \
+      if (!(x))                                                   \
+        {                                                         \
+          std::cout << "Check failed (" << __LINE__ << "): " #x   \
+                    << std::endl;                                 \
+          return -1;                                              \
+        }                                                         \
+    }                                                             \
+  while (0)
+
+#endif // CHECK_H
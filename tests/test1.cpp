@@ -1,6 +1,9 @@
 #include <litejson.h>
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
 
 int main(int argc, char** argv)
 {
@@ -10,7 +13,31 @@ int main(int argc, char** argv)
       return -2;
     }
 
-  litejson::json_loader loader(argv[1]);
+  litejson::json_loader::parse_mode_t mode = litejson::json_loader::pm_single_pass;
+  bool from_buffer = false;
+
+  for (int i = 2; i < argc; i++)
+    {
+      if (std::strcmp(argv[i], "--two-pass") == 0)
+        mode = litejson::json_loader::pm_two_pass;
+      else if (std::strcmp(argv[i], "--lazy") == 0)
+        mode = litejson::json_loader::pm_lazy;
+      else if (std::strcmp(argv[i], "--buffer") == 0)
+        from_buffer = true;
+    }
+
+  litejson::json_loader loader;
+
+  if (from_buffer)
+    {
+      std::ifstream ifs(argv[1], std::ios::binary);
+      std::stringstream ss;
+
+      ss << ifs.rdbuf();
+      loader.load(ss.str(), mode);
+    }
+  else
+    loader.load_file(argv[1], mode);
 
   if (loader.bad())
     {
@@ -0,0 +1,80 @@
+#include <litejson.h>
+#include <json_writer.h>
+
+#include <iostream>
+
+#include "check.h"
+
+using litejson::json_loader;
+using litejson::json_writer;
+
+static std::string entry(int i)
+{
+  return "{\"id\": " + std::to_string(i) + ", \"name\": \"item, [" + std::to_string(i) + "] {\\\"x\\\": 1}\", "
+         "\"price\": " + std::to_string(i * 0.25) + ", \"tags\": [\"a\", \"b\", {\"c\": [null, true, false]}]}";
+}
+
+/**
+ * Parse text in both modes and compare the trees
+ */
+static bool same(const std::string& text, unsigned threads)
+{
+  json_loader serial;
+  json_loader parallel;
+
+  parallel.set_threads(threads);
+  if (!serial.load(text) || !parallel.load(text, json_loader::pm_parallel))
+    return false;
+  return json_writer::to_string(*serial.root()) == json_writer::to_string(*parallel.root());
+}
+
+int main()
+{
+  std::string array = "  [";
+  std::string object = "{";
+
+  for (int i = 0; array.size() < 2 * json_loader::parallel_min; i++)
+    array += (i != 0 ? ",\n" : "\n") + entry(i);
+  array += "\n]  \n";
+
+  for (int i = 0; object.size() < 2 * json_loader::parallel_min; i++)
+    object += (i != 0 ? ", \"k" : "\"k") + std::to_string(i % 5000) + "\" : " + entry(i);   // With duplicates
+  object += "}";
+
+  for (unsigned threads : { 1, 3, 8 })
+    {
+      CHECK(same(array, threads));
+      CHECK(same(object, threads));
+    }
+
+  // Small text and scalar root
+  CHECK(same("[1, 2, 3]", 4));
+  CHECK(same("\"text\"", 4));
+
+  // Errors are the same as in the serial mode
+  json_loader loader;
+  std::string bad[] = { array.substr(0, array.size() - 5),
+                        array.substr(0, array.size() - 5) + ",]",
+                        array + "1",
+                        "[1, " + array.substr(2),
+                        object.substr(0, object.size() - 1) + ", 5: 1}",
+                        object.substr(0, object.size() - 1) + ", \"a\" 1}" };
+
+  for (const std::string& b : bad)
+    {
+      CHECK(!loader.load(b));
+      CHECK(!loader.load(b, json_loader::pm_parallel));
+      CHECK(loader.root() == nullptr);
+    }
+
+  // Tree stays valid till the next load
+  loader.set_threads(4);
+  CHECK(loader.load(array, json_loader::pm_parallel));
+  CHECK(loader.root()->as_array(1000)->as_object("id")->as_integer() == 1000);
+  CHECK(loader.root()->as_array(7)->as_object("name")->as_string() == "item, [7] {\"x\": 1}");
+  CHECK(loader.load(object, json_loader::pm_parallel));
+  CHECK(loader.root()->as_object("k1")->as_object("id")->as_integer() > 5000);
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <litejson.h>
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+
+#include "check.h"
+
+using litejson::json_loader;
+using litejson::json_stats;
+using litejson::json_value;
+
+static const char text[] =
+  "{\n"
+  "  \"name\": \"first\",\n"
+  "  \"list\": [1, 2.5, true, null, [7], {\"k\": 8}],\n"
+  "  \"nested\": {\"deep\": [[\"a long string value\"]]}\n"
+  "}\n";
+
+int main()
+{
+  json_loader loader;
+  std::string file_name = "t_test16.json";
+  std::map<std::string, double> counters;
+  FILE* file;
+
+  CHECK(loader.stats() == nullptr);                     // Off by default
+  CHECK(loader.load(text));
+  CHECK(loader.stats() == nullptr);
+
+  file = std::fopen(file_name.c_str(), "w");
+  CHECK(file != nullptr);
+  std::fputs(text, file);
+  std::fclose(file);
+
+  loader.enable_stats(true);
+  for (json_loader::parse_mode_t mode : { json_loader::pm_single_pass, json_loader::pm_two_pass, json_loader::pm_parallel })
+    for (bool from_file : { false, true })
+      {
+        CHECK(from_file ? loader.load_file(file_name, mode) : loader.load(text, mode));
+
+        const json_stats& st = *loader.stats();
+
+        CHECK(st.bytes == sizeof(text) - 1);
+        CHECK(st.nodes[json_value::t_null] == 1);
+        CHECK(st.nodes[json_value::t_boolean] == 1);
+        CHECK(st.nodes[json_value::t_number] == 4);
+        CHECK(st.nodes[json_value::t_string] == 2);
+        CHECK(st.nodes[json_value::t_array] == 4);
+        CHECK(st.nodes[json_value::t_object] == 3);
+        CHECK(st.lazy_nodes == 0);
+        CHECK(st.tokens == 39);
+        CHECK(st.max_depth == 4);
+        CHECK(st.max_array == 6);
+        CHECK(st.max_object == 3);
+        CHECK(st.string_bytes == 4 + 5 + 4 + 1 + 6 + 4 + 19);
+        CHECK(st.allocations >= 1 && st.allocated >= 64 * 1024);
+        if (mode == json_loader::pm_two_pass)
+          CHECK(st.time[json_stats::ph_lexical] > 0 && st.time[json_stats::ph_syntax] > 0 && st.time[json_stats::ph_parse] == 0);
+        else
+          CHECK(st.time[json_stats::ph_lexical] == 0 && st.time[json_stats::ph_parse] > 0);
+        CHECK(from_file == (st.time[json_stats::ph_read] > 0) || mode == json_loader::pm_two_pass);
+      }
+
+  // Last line without new line is read too
+  file = std::fopen(file_name.c_str(), "w");
+  CHECK(file != nullptr);
+  std::fputs("[1, 2,\n 3]", file);
+  std::fclose(file);
+  CHECK(loader.load_file(file_name, json_loader::pm_two_pass));
+  CHECK(loader.root()->size() == 3 && loader.stats()->bytes == 10);
+
+  // Nothing of the lazy document is parsed by the load
+  CHECK(loader.load(text, json_loader::pm_lazy));
+  CHECK(loader.stats()->nodes[json_value::t_object] == 0);
+  CHECK(loader.stats()->lazy_nodes == 1);
+  CHECK(loader.stats()->time[json_stats::ph_parse] > 0);
+
+  // Failed load has no tree to count
+  CHECK(!loader.load("[1, 2"));
+  CHECK(loader.stats()->bytes == 5 && loader.stats()->tokens == 0);
+
+  // Deep tree is counted without recursion
+  loader.set_max_depth(1000000);
+  CHECK(loader.load(std::string(1000000, '[') + std::string(1000000, ']')));
+  CHECK(loader.stats()->max_depth == 1000000 && loader.stats()->nodes[json_value::t_array] == 1000000);
+  loader.set_max_depth(json_loader::default_max_depth);
+
+  // Export
+  CHECK(loader.load(text));
+  loader.stats()->for_each([&](const char* name, double value) { counters[name] = value; });
+  CHECK(counters.size() == 21);
+  CHECK(counters["objects"] == 3 && counters["string_bytes"] == 43 && counters["bytes"] == sizeof(text) - 1);
+  CHECK(counters.count("time_parse") == 1);
+  CHECK(counters.count("keys_interned") == 1 && counters["key_bytes_saved"] == 0);
+
+  loader.enable_stats(false);
+  CHECK(loader.stats() == nullptr);
+  CHECK(loader.load(text));
+
+  std::remove(file_name.c_str());
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
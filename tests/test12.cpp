@@ -0,0 +1,119 @@
+#include <json_snapshot.h>
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+using litejson::json_document;
+using litejson::json_loader;
+using litejson::json_snapshot;
+
+static std::unique_ptr<json_document> make_version(int version)
+{
+  std::string text = "{\"version\": " + std::to_string(version) + ", \"items\": [";
+
+  for (int i = 0; i < 20; i++)
+    text += (i != 0 ? ", " : "") + std::to_string(version);
+  return std::unique_ptr<json_document>(new json_document(text + "]}"));
+}
+
+/**
+ * All items of the version are equal to its number
+ */
+static bool consistent(const json_document& doc)
+{
+  int version = doc.root()->as_object("version")->as_integer();
+
+  for (int i = 0; i < 20; i++)
+    if (doc.root()->as_object("items")->as_array(i)->as_integer() != version)
+      return false;
+  return true;
+}
+
+int main()
+{
+  json_snapshot snapshot;
+
+  // Documents
+  json_document lazy("{\"a\": [1, 2, {\"b\": 3}]}", json_loader::pm_lazy);
+  json_document bad("{\"a\": ");
+
+  CHECK(!lazy.bad() && lazy.root()->as_object("a")->as_array(2)->as_object("b")->as_integer() == 3);
+  CHECK(bad.bad() && bad.root() == nullptr);
+  CHECK(json_document::from_file("does-not-exist.json")->bad());
+
+  // Old version lives while it is read
+  CHECK(!snapshot.read());
+  snapshot.publish(make_version(1));
+  {
+    json_snapshot::reader first = snapshot.read();
+
+    snapshot.publish(make_version(2));
+    CHECK(snapshot.retired() == 1);
+    CHECK(first->root()->as_object("version")->as_integer() == 1);
+    CHECK(snapshot.read()->root()->as_object("version")->as_integer() == 2);
+  }
+  snapshot.reclaim();
+  CHECK(snapshot.retired() == 0);
+
+  // Nested readers of one thread
+  {
+    std::vector<json_snapshot::reader> readers;
+    bool thrown = false;
+
+    for (unsigned i = 0; i < json_snapshot::max_nesting; i++)
+      readers.push_back(snapshot.read());
+    try
+      {
+        snapshot.read();
+      }
+    catch (const std::runtime_error&)
+      {
+        thrown = true;
+      }
+    CHECK(thrown);
+    snapshot.publish(make_version(3));
+    CHECK(snapshot.retired() == 1);
+  }
+  snapshot.publish(make_version(4));
+  CHECK(snapshot.retired() == 0);
+
+  // Readers never see deleted or partly made version
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([&]()
+      {
+        int last = 0;
+
+        while (!stop.load())
+          {
+            json_snapshot::reader r = snapshot.read();
+            int version = r->root()->as_object("version")->as_integer();
+
+            if (!consistent(*r) || version < last)
+              errors++;
+            last = version;
+          }
+      });
+
+  for (int v = 5; v < 500; v++)
+    snapshot.publish(make_version(v));
+  stop = true;
+  for (std::thread& t : threads)
+    t.join();
+
+  CHECK(errors == 0);
+  snapshot.reclaim();
+  CHECK(snapshot.retired() == 0);
+  CHECK(snapshot.read()->root()->as_object("version")->as_integer() == 499);
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <json_cache.h>
+#include <json_writer.h>
+#include <litejson.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+using litejson::json_cache;
+using litejson::json_loader;
+using litejson::json_writer;
+
+static void write_file(const std::string& name, const std::string& text)
+{
+  std::ofstream file(name, std::ios::binary | std::ios::trunc);
+
+  file << text;
+}
+
+static std::string read_file(const std::string& name)
+{
+  std::ifstream file(name, std::ios::binary);
+  std::stringstream text;
+
+  text << file.rdbuf();
+  return text.str();
+}
+
+int main()
+{
+  std::string source = "t_test18.json";
+  std::string cache_name = "t_test18.bin";
+  std::string text = "{\"name\": \"a string longer than fourteen bytes\", \"short\": \"abc\", \"empty\": [], \"none\": {},"
+                     " \"numbers\": [-1, 18446744073709551615, 2.5e-3, 0], \"flags\": [true, false, null], \"dup\": 1,"
+                     " \"dup\": 2, \"unicode\": \"\\u00e9\\ud83d\\ude00\", \"nested\": [[[{\"deep\": \"value\"}]]], \"wide\": {";
+  json_loader loader;
+  json_cache cache;
+  std::string expected;
+
+  for (int i = 0; i < 100; i++)
+    text += (i != 0 ? ", \"key" : "\"key") + std::to_string(i) + "\": \"value number " + std::to_string(i) + "\"";
+  text += "}}";
+  write_file(source, text);
+
+  // Text to cache and back
+  CHECK(loader.load(text));
+  expected = json_writer::to_string(*loader.root());
+  CHECK(json_cache::build(source, cache_name));
+  CHECK(cache.open(cache_name));
+  CHECK(json_writer::to_string(*cache.root()) == expected);
+  CHECK(cache.root()->as_object("dup")->as_integer() == 2);
+  CHECK(cache.root()->as_object("wide")->as_object("key77")->as_string() == "value number 77");
+  CHECK(cache.root()->as_object("wide")->as_object("key100") == nullptr);
+  CHECK(cache.root()->at_pointer("/nested/0/0/0/deep")->as_string() == "value");
+  CHECK(cache.root()->as_object("numbers")->as_array(1)->as_uint64() == 18446744073709551615ull);
+  CHECK(cache.write_text("t_test18.out.json", 2));
+  CHECK(loader.load(read_file("t_test18.out.json")));
+  CHECK(json_writer::to_string(*loader.root()) == expected);
+
+  // Lazy tree is parsed by write()
+  CHECK(loader.load(text, json_loader::pm_lazy));
+  CHECK(json_cache::write(*loader.root(), "t_test18.lazy.bin"));
+  CHECK(cache.open("t_test18.lazy.bin"));
+  CHECK(json_writer::to_string(*cache.root()) == expected);
+  CHECK(json_cache::is_stale("t_test18.lazy.bin", source));      // No source recorded
+
+  // Scalar root
+  CHECK(loader.load("\"only a single long string value\""));
+  CHECK(json_cache::write(*loader.root(), "t_test18.lazy.bin"));
+  CHECK(cache.open("t_test18.lazy.bin"));
+  CHECK(cache.root()->as_string() == "only a single long string value");
+
+  // Staleness
+  json_cache reader(cache_name);
+
+  CHECK(!json_cache::is_stale(cache_name, source));
+  write_file(source, "{\"version\": 2}");
+  CHECK(json_cache::is_stale(cache_name, source));
+  CHECK(cache.open_or_build(source, cache_name));
+  CHECK(cache.root()->as_object("version")->as_integer() == 2);
+  CHECK(!json_cache::is_stale(cache_name, source));
+  CHECK(reader.root()->as_object("dup")->as_integer() == 2);     // Old mapping is still valid
+
+  // Concurrent builders write their own temporary files
+  std::vector<std::thread> builders;
+  bool built[4] = { false, false, false, false };
+
+  for (int i = 0; i < 4; i++)
+    builders.emplace_back([&, i] { built[i] = json_cache::build(source, cache_name); });
+  for (std::thread& t : builders)
+    t.join();
+  CHECK(built[0] && built[1] && built[2] && built[3]);
+  CHECK(cache.open(cache_name) && cache.root()->as_object("version")->as_integer() == 2);
+  CHECK(!json_cache::is_stale(cache_name, source));
+
+  // Bad files
+  std::string bin = read_file(cache_name);
+
+  write_file("t_test18.bad.bin", bin.substr(0, bin.size() - 1));
+  CHECK(!cache.open("t_test18.bad.bin") && cache.root() == nullptr);
+  write_file("t_test18.bad.bin", "X" + bin.substr(1));
+  CHECK(!cache.open("t_test18.bad.bin"));
+  CHECK(json_cache::is_stale("t_test18.bad.bin", source));
+  CHECK(!cache.open("does-not-exist.bin"));
+  write_file(source, "{\"broken\": ");
+  CHECK(!cache.open_or_build(source, cache_name));
+
+  for (const char* name : { "t_test18.json", "t_test18.bin", "t_test18.out.json", "t_test18.lazy.bin", "t_test18.bad.bin" })
+    std::remove(name);
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
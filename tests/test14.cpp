@@ -0,0 +1,179 @@
+#include <json_bind.h>
+#include <litejson.h>
+
+#include <iostream>
+
+#include "check.h"
+
+struct server
+{
+  std::string host;
+  uint16_t port = 0;
+  std::optional<double> weight;
+  bool enabled = true;
+
+  bool operator==(const server& o) const
+  {
+    return host == o.host && port == o.port && weight == o.weight && enabled == o.enabled;
+  }
+};
+
+struct config
+{
+  std::string name;
+  int64_t version = 0;
+  std::vector<server> servers;
+  std::map<std::string, std::vector<int>> groups;
+  float ratio = 0;
+  uint64_t big = 0;
+
+  bool operator==(const config& o) const
+  {
+    return name == o.name && version == o.version && servers == o.servers && groups == o.groups &&
+           ratio == o.ratio && big == o.big;
+  }
+};
+
+template<>
+struct litejson::json_fields<server>
+{
+  static constexpr auto list = std::make_tuple(litejson::field("host", &server::host),
+                                               litejson::field("port", &server::port),
+                                               litejson::field("weight", &server::weight),
+                                               litejson::optional_field("enabled", &server::enabled));
+};
+
+template<>
+struct litejson::json_fields<config>
+{
+  static constexpr auto list = std::make_tuple(litejson::field("name", &config::name),
+                                               litejson::field("version", &config::version),
+                                               litejson::field("servers", &config::servers),
+                                               litejson::field("groups", &config::groups),
+                                               litejson::field("ratio", &config::ratio),
+                                               litejson::field("big", &config::big));
+};
+
+static bool fails(const std::string& text, const std::string& message)
+{
+  config c;
+  std::string error;
+
+  if (litejson::from_json(text, c, &error))
+    return false;
+  if (error.find(message) == std::string::npos)
+    {
+      std::cout << "Unexpected error: " << error << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int main()
+{
+  std::string text =
+    "{\n"
+    "  \"name\": \"main \\\"cluster\\\"\",\n"
+    "  \"unknown\": {\"deep\": [1, {\"x\": null}, \"s\"]},\n"
+    "  \"version\": -7,\n"
+    "  \"servers\": [\n"
+    "    {\"host\": \"a\", \"port\": 80, \"weight\": 0.5},\n"
+    "    {\"port\": 81, \"host\": \"b\", \"weight\": null, \"enabled\": false}\n"
+    "  ],\n"
+    "  \"groups\": {\"x\": [1, 2], \"y\": []},\n"
+    "  \"ratio\": 1.5,\n"
+    "  \"big\": 18446744073709551615,\n"
+    "  \"version\": 3\n"
+    "}\n";
+  config c;
+  config back;
+  std::string error;
+  litejson::json_loader loader;
+
+  CHECK(litejson::from_json(text, c, &error));
+  CHECK(c.name == "main \"cluster\"");
+  CHECK(c.version == 3);                                // Later duplicate wins
+  CHECK(c.servers.size() == 2);
+  CHECK(c.servers[0].host == "a" && c.servers[0].port == 80 && c.servers[0].weight == 0.5 && c.servers[0].enabled);
+  CHECK(c.servers[1].host == "b" && !c.servers[1].weight && !c.servers[1].enabled);
+  CHECK(c.groups.size() == 2 && c.groups["x"] == std::vector<int>({1, 2}) && c.groups["y"].empty());
+  CHECK(c.ratio == 1.5f);
+  CHECK(c.big == 18446744073709551615ull);
+
+  // Round trip, the text is the same as made by the tree
+  for (int indent : { 0, 2 })
+    {
+      std::string out = litejson::to_json(c, indent);
+
+      CHECK(litejson::from_json(out, back, &error));
+      CHECK(back == c);
+      CHECK(loader.load(out));
+      CHECK(litejson::json_writer::to_string(*loader.root(), indent) == out);
+    }
+  CHECK(litejson::to_json(c.servers[1]) == "{\"host\":\"b\",\"port\":81,\"enabled\":false}");
+  CHECK(litejson::to_json(std::vector<std::optional<int>>{1, std::nullopt}) == "[1,null]");
+  CHECK(litejson::to_json(std::vector<float>{0.1f, 16777216.0f}) == "[0.1,16777216]");
+
+  std::vector<bool> flags;
+
+  CHECK(litejson::from_json("[true, false, true]", flags) && flags == std::vector<bool>({ true, false, true }));
+  CHECK(litejson::to_json(flags) == "[true,false,true]");
+  CHECK(!litejson::from_json("[true, 1]", flags, &error) && error.find("at /1: boolean expected") != std::string::npos);
+
+  std::vector<int> zeros;
+
+  CHECK(litejson::from_json("[-0, 0]", zeros) && zeros == std::vector<int>({ 0, 0 }));
+
+  // Large value goes to the sink by parts
+  std::vector<std::string> names(20000, "name of the entry");
+  std::string streamed;
+  size_t parts = 0;
+
+  litejson::to_json(names, [&](std::string_view text) { streamed += text; parts++; });
+  CHECK(parts > 1 && streamed == litejson::to_json(names));
+
+  // Errors tell the line and the pointer
+  std::string base = "{\"name\": \"n\", \"version\": 1, \"groups\": {}, \"ratio\": 0, \"big\": 0, \"servers\": ";
+
+  CHECK(fails(base + "[{\"host\": \"a\", \"port\": \"80\"}]}", "Error (1) at /servers/0/port: integer expected"));
+  CHECK(fails(base + "[{\"host\": \"a\", \"port\": 80}, {\"host\": \"b\"}]}", "at /servers/1: missing member ``port''"));
+  CHECK(fails(base + "[{\"host\": \"a\", \"port\": 65536}]}", "/servers/0/port: integer out of range"));
+  CHECK(fails(base + "[{\"host\": \"a\", \"port\": 1.5}]}", "integer expected"));
+  CHECK(fails(base + "[{\"host\": 5, \"port\": 1}]}", "/servers/0/host: string expected"));
+  CHECK(fails(base + "{}}", "/servers: array expected"));
+  CHECK(fails(base + "[]", "``,'' or ``}'' expected"));
+  CHECK(fails(base + "[]} x", "after the end of JSON value"));
+  CHECK(fails(base + "[], \"groups\": {\"a/b\": [1, true]}}", "at /groups/a~1b/1: integer expected"));
+  CHECK(fails(base + "[], \"unknown\": [1, }", "value expected"));
+  CHECK(fails(base + "[], \"unknown\": " + std::string(1000000, '[') + "}", "nesting is too deep"));
+  CHECK(!fails(base + "[], \"unknown\": " + std::string(1024, '[') + std::string(1024, ']') + "}", ""));
+
+  litejson::json_reader deep("[[{\"a\": [1]}], 2]");
+
+  deep.set_max_depth(3);
+  CHECK(!deep.skip() && deep.error().find("nesting is too deep") != std::string::npos);
+  CHECK(fails("{\"name\": \"n\"}", "missing member ``version''"));
+  CHECK(fails("{\n\n\"name\": \"n\", \"version\": -1e400}", "Error (3) at /version: integer expected"));
+
+  // Streaming writer
+  litejson::json_writer w(2);
+
+  w.begin_object();
+  w.key("a");
+  w.begin_array();
+  w.value(1);
+  w.value(2.5);
+  w.value("s");
+  w.null_value();
+  w.begin_object();
+  w.end_object();
+  w.end_array();
+  w.key("b");
+  w.write(*loader.root()->as_object("groups"));
+  w.end_object();
+  CHECK(loader.load(w.str()));
+  CHECK(litejson::json_writer::to_string(*loader.root(), 2) == w.str());
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
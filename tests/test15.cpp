@@ -0,0 +1,126 @@
+#include <json_sax.h>
+#include <litejson.h>
+
+#include <iostream>
+
+#include "check.h"
+
+/**
+ * Records all events as text
+ */
+struct recorder
+{
+  std::string events;
+
+  bool null() { events += "n "; return true; }
+  bool boolean(bool val) { events += val ? "t " : "f "; return true; }
+  bool number(const litejson::json_value& num)
+  {
+    if (!num.is_integer())
+      events += "d" + std::to_string(num.as_double());
+    else if (num.as_double() < 0)
+      events += "i" + std::to_string(num.as_int64());
+    else
+      events += "i" + std::to_string(num.as_uint64());
+    events += " ";
+    return true;
+  }
+  bool string(std::string_view str) { events += "s:" + std::string(str) + " "; return true; }
+  bool key(std::string_view name) { events += "k:" + std::string(name) + " "; return true; }
+  bool begin_object() { events += "{ "; return true; }
+  bool end_object() { events += "} "; return true; }
+  bool begin_array() { events += "[ "; return true; }
+  bool end_array() { events += "] "; return true; }
+};
+
+/**
+ * Sum of the member "price", stops at the first member "stop"
+ */
+struct price_sum : litejson::json_sax_handler
+{
+  double total = 0;
+  int numbers = 0;
+  bool is_price = false;
+
+  bool key(std::string_view name) { is_price = name == "price"; return name != "stop"; }
+  bool number(const litejson::json_value& num)
+  {
+    numbers++;
+    if (is_price)
+      total += num.as_double();
+    return true;
+  }
+};
+
+static std::string events(const std::string& text)
+{
+  recorder r;
+  litejson::json_sax_parser<recorder> parser(r);
+
+  if (!parser.parse(text))
+    return parser.error();
+  return r.events;
+}
+
+int main()
+{
+  CHECK(events("{\"a\": [1, -2.5, \"x\\ty\", true, false, null, {}, []], \"b\\u00e9\": {\"c\": 18446744073709551615}}") ==
+        "{ k:a [ i1 d-2.500000 s:x\ty t f n { } [ ] ] k:b\xc3\xa9 { k:c i18446744073709551615 } } ");
+  CHECK(events(" 42 ") == "i42 ");
+  CHECK(events("\"s\"") == "s:s ");
+  CHECK(events("[[[]]]") == "[ [ [ ] ] ] ");
+
+  // Errors
+  CHECK(events("") == "Syntax error (1): Unexpected end of file");
+  CHECK(events("[1,\n2") == "Syntax error (2): ``,'' or ``]'' expected");
+  CHECK(events("{\"a\" 1}") == "Syntax error (1): ``:'' expected");
+  CHECK(events("{\"a\": 1,}") == "Syntax error (1): String expected");
+  CHECK(events("{\"a\": 1]") == "Syntax error (1): ``,'' or ``}'' expected");
+  CHECK(events("[1,]") == "Syntax error (1): Value expected");
+  CHECK(events("[nul]") == "Syntax error (1): Value expected");
+  CHECK(events("[\"a\xff\"]") == "Syntax error (1): Bad string");
+  CHECK(events("1 2") == "Syntax error (1): Extra characters after the end of JSON value");
+
+  // Aggregation with abort
+  {
+    price_sum sum;
+    litejson::json_sax_parser<price_sum> parser(sum);
+
+    CHECK(parser.parse("[{\"price\": 1.5, \"n\": 3}, {\"price\": 2}]"));
+    CHECK(sum.total == 3.5 && sum.numbers == 3);
+
+    sum = price_sum();
+    CHECK(!parser.parse("[{\"price\": 1}, {\"stop\": 0}, {\"price\": 2}]"));
+    CHECK(parser.aborted() && sum.total == 1 && sum.numbers == 1);
+    CHECK(!parser.error().empty());
+
+    CHECK(!parser.parse("[{\"price\": 1}, x]"));
+    CHECK(!parser.aborted() && sum.total == 2);
+  }
+
+  // Depth limit, deep text does not use the call stack
+  {
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+    litejson::json_sax_handler handler;
+    litejson::json_sax_parser<litejson::json_sax_handler> parser(handler);
+
+    CHECK(!parser.parse(deep));
+    CHECK(parser.error() == "Syntax error (1): Nesting is too deep");
+    parser.set_max_depth(100000);
+    CHECK(parser.parse(deep));
+    parser.set_max_depth(99999);
+    CHECK(!parser.parse(deep));
+  }
+
+  // Same text is accepted by the loader
+  {
+    litejson::json_loader loader;
+    std::string text = "{\"list\": [1, 2, {\"x\": null}], \"s\": \"\\\"q\\\"\"}";
+
+    CHECK(loader.load(text));
+    CHECK(events(text) == "{ k:list [ i1 i2 { k:x n } ] k:s s:\"q\" } ");
+  }
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <litejson.h>
+#include <json_writer.h>
+
+#include <iostream>
+
+#include "check.h"
+
+int main()
+{
+  litejson::json_value root;
+  std::string long_key = "this key does not fit inline";
+  std::string_view view = long_key;
+
+  // Building by the new calls
+  litejson::json_value& items = root.emplace_object_entry("items");
+
+  items.make_array();
+  items.reserve(1000);
+  for (int i = 0; i < 1000; i++)
+    {
+      litejson::json_value& item = items.emplace_array_entry();
+
+      item.make_object();
+      item.reserve(3);
+      item.emplace_object_entry("id", i);
+      item.emplace_object_entry("name", "item " + std::to_string(i));
+      item.add_object_entry(view, litejson::json_value(i % 2 == 0));
+    }
+  root.add_object_entry("count", litejson::json_value(1000u));
+  root.add_object_entry({litejson::json_value(long_key + "!"), litejson::json_value("moved")});
+  root.emplace_object_entry("count", 1001);           // Duplicate is replaced
+  root.emplace_object_entry("pi", 3.25);
+  root.emplace_object_entry("none");
+
+  CHECK(root.as_object("items")->as_array(999)->as_object("id")->as_integer() == 999);
+  CHECK(root.as_object("items")->as_array(998)->as_object("name")->as_string() == "item 998");
+  CHECK(root.as_object("items")->as_array(4)->as_object(long_key)->as_boolean());
+  CHECK(root.as_object("items")->as_array(1000) == nullptr);
+  CHECK(root.as_object("count")->as_integer() == 1001);
+  CHECK(root.as_object(long_key + "!")->as_string() == "moved");
+  CHECK(root.as_object("none")->is_null());
+
+  // Same text as the tree made by the old calls
+  litejson::json_value old_root;
+  litejson::json_value* old_items = new litejson::json_value();
+
+  for (int i = 0; i < 1000; i++)
+    {
+      litejson::json_value* item = new litejson::json_value();
+
+      item->add_object_entry("id", new litejson::json_value(i));
+      item->add_object_entry("name", new litejson::json_value("item " + std::to_string(i)));
+      item->add_object_entry(long_key, new litejson::json_value(i % 2 == 0));
+      old_items->add_array_entry(item);
+    }
+  old_root.add_object_entry("items", old_items);
+  old_root.add_object_entry("count", new litejson::json_value(1001));
+  old_root.add_object_entry(long_key + "!", new litejson::json_value("moved"));
+  old_root.add_object_entry("pi", new litejson::json_value(3.25));
+  old_root.add_object_entry("none", new litejson::json_value());
+
+  CHECK(litejson::json_writer::to_string(root) == litejson::json_writer::to_string(old_root));
+
+  // Large object gets the index, keys are still found after growth
+  litejson::json_value big;
+
+  big.make_object();
+  big.reserve(20);
+  for (int i = 0; i < 100; i++)
+    big.emplace_object_entry("key" + std::to_string(i), i);
+  big.emplace_object_entry("key50", -50);
+  for (int i = 0; i < 100; i++)
+    CHECK(big.as_object("key" + std::to_string(i))->as_integer() == (i == 50 ? -50 : i));
+
+  // Entries are added to the copy of the loaded tree
+  litejson::json_loader loader;
+
+  CHECK(loader.load("{\"a\": [1, 2], \"b\": {\"c\": 3}}"));
+
+  litejson::json_value doc(*loader.root());
+
+  doc.as_object("a")->reserve(10);
+  doc.as_object("a")->emplace_array_entry("three");
+  doc.as_object("b")->emplace_object_entry("d", false);
+  doc.emplace_object_entry("e", *doc.as_object("b"));
+  CHECK(litejson::json_writer::to_string(doc) ==
+        "{\"a\":[1,2,\"three\"],\"b\":{\"c\":3,\"d\":false},\"e\":{\"c\":3,\"d\":false}}");
+
+  // Errors
+  try
+    {
+      litejson::json_value number(5);
+
+      number.reserve(10);
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  try
+    {
+      root.add_object_entry({litejson::json_value(5), litejson::json_value(1)});
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
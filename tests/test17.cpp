@@ -0,0 +1,103 @@
+#include <litejson.h>
+#include <json_writer.h>
+
+#include <iostream>
+
+#include "check.h"
+
+using litejson::json_loader;
+
+static std::string nested_arrays(size_t depth)
+{
+  return std::string(depth, '[') + "1" + std::string(depth, ']');
+}
+
+static std::string nested_objects(size_t depth)
+{
+  std::string text;
+
+  for (size_t i = 0; i < depth; i++)
+    text += "{\"a\": ";
+  text += "null";
+  for (size_t i = 0; i < depth; i++)
+    text += "}";
+  return text;
+}
+
+int main()
+{
+  json_loader loader;
+  const json_loader::parse_mode_t modes[] = { json_loader::pm_single_pass, json_loader::pm_two_pass };
+
+  for (json_loader::parse_mode_t mode : modes)
+    {
+      // Default limit
+      CHECK(loader.load(nested_arrays(json_loader::default_max_depth), mode));
+      CHECK(!loader.load(nested_arrays(json_loader::default_max_depth + 1), mode));
+      CHECK(loader.load(nested_objects(json_loader::default_max_depth), mode));
+      CHECK(!loader.load(nested_objects(json_loader::default_max_depth + 1), mode));
+
+      // Deep text fails without the stack overflow
+      CHECK(!loader.load(std::string(100000, '['), mode));
+      CHECK(!loader.load(nested_arrays(100000), mode));
+
+      // Deep text is parsed without recursion when it is allowed
+      litejson::json_value* node;
+      size_t depth = 0;
+
+      loader.set_max_depth(100000);
+      CHECK(loader.load(nested_arrays(100000), mode));
+      for (node = loader.root(); node->is_array(); node = node->as_array(0))
+        depth++;
+      CHECK(depth == 100000 && node->as_integer() == 1);
+      CHECK(litejson::json_writer::to_string(*loader.root()) == nested_arrays(100000));
+      CHECK(!loader.load(nested_arrays(100001), mode));
+
+      loader.set_max_depth(3);
+      CHECK(loader.load("[{\"a\": [], \"b\": {}}, [[]], 1]", mode));
+      CHECK(!loader.load("[{\"a\": [[]]}]", mode));
+      loader.set_max_depth(0);
+      CHECK(loader.load("\"scalar\"", mode));
+      CHECK(!loader.load("[]", mode));
+      loader.set_max_depth(json_loader::default_max_depth);
+
+      // Empty containers, truncated and bad text
+      CHECK(loader.load("[[], {}, [{}], {\"a\": []}]", mode));
+      CHECK(litejson::json_writer::to_string(*loader.root()) == "[[],{},[{}],{\"a\":[]}]");
+      CHECK(loader.load(" {} ", mode) && loader.root()->is_object());
+      CHECK(!loader.load("[1, 2", mode));
+      CHECK(!loader.load("{\"a\": 1", mode));
+      CHECK(!loader.load("{\"a\"", mode));
+      CHECK(!loader.load("{\"a\" 1}", mode));
+      CHECK(!loader.load("{1: 1}", mode));
+      CHECK(!loader.load("[1 2]", mode));
+      CHECK(!loader.load("[1, ]", mode));
+      CHECK(!loader.load("{\"a\": 1]", mode));
+      CHECK(!loader.load("[", mode));
+      CHECK(!loader.load("", mode));
+    }
+
+  // Lazy mode checks all the brackets when it opens the text
+  CHECK(loader.load(nested_arrays(json_loader::default_max_depth), json_loader::pm_lazy));
+  CHECK(!loader.load(nested_arrays(json_loader::default_max_depth + 1), json_loader::pm_lazy));
+  CHECK(!loader.load("[1, " + nested_objects(json_loader::default_max_depth) + "]", json_loader::pm_lazy));
+  CHECK(!loader.load(nested_arrays(200000), json_loader::pm_lazy));
+  loader.set_max_depth(200000);
+  CHECK(loader.load(nested_arrays(200000), json_loader::pm_lazy));
+  CHECK(litejson::json_writer::to_string(*loader.root()) == nested_arrays(200000));
+  loader.set_max_depth(json_loader::default_max_depth);
+
+  // Entries of the parallel mode are limited as a part of the whole text
+  std::string wide = "[";
+
+  while (wide.size() < 2 * json_loader::parallel_min)
+    wide += "[[1, 2], {\"k\": [3]}],\n";
+
+  loader.set_threads(2);
+  CHECK(loader.load(wide + nested_arrays(json_loader::default_max_depth - 1) + "]", json_loader::pm_parallel));
+  CHECK(!loader.load(wide + nested_arrays(json_loader::default_max_depth) + "]", json_loader::pm_parallel));
+  CHECK(!loader.load(wide + std::string(100000, '[') + "]", json_loader::pm_parallel));
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
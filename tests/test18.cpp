@@ -0,0 +1,108 @@
+#include <litejson.h>
+#include <json_document.h>
+#include <json_writer.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "check.h"
+
+using litejson::json_loader;
+
+static bool inside(std::string_view str, std::string_view text)
+{
+  return str.data() >= text.data() && str.data() + str.size() <= text.data() + text.size();
+}
+
+int main()
+{
+  const std::string text =
+    "{\"this key is long enough\": \"plain value which is long\", \"short\": \"inline\",\n"
+    " \"escaped\": \"value with \\\"quotes\\\" inside\", \"list\": [\"another long plain string\", \"\\u00e9t\\u00e9 long enough\"]}";
+  json_loader loader;
+  const litejson::json_value* root;
+
+  // Copies
+  CHECK(loader.load(text));
+  root = loader.root();
+  CHECK(!inside(root->as_object("this key is long enough")->as_string_view(), text));
+  CHECK(root->as_object("this key is long enough")->as_string() == "plain value which is long");
+  std::string copied = litejson::json_writer::to_string(*root);
+
+  // Views of the caller text
+  loader.set_zero_copy(true);
+  for (json_loader::parse_mode_t mode : { json_loader::pm_single_pass, json_loader::pm_two_pass })
+    {
+      CHECK(loader.load(text, mode));
+      root = loader.root();
+      CHECK(litejson::json_writer::to_string(*root) == copied);
+      CHECK(inside(root->as_object("this key is long enough")->as_string_view(), text) ==
+            (mode == json_loader::pm_single_pass));
+      CHECK(inside(root->as_object("list")->as_array(0)->as_string_view(), text) == (mode == json_loader::pm_single_pass));
+      CHECK(!inside(root->as_object("escaped")->as_string_view(), text));
+      CHECK(root->as_object("escaped")->as_string() == "value with \"quotes\" inside");
+      CHECK(!inside(root->as_object("list")->as_array(1)->as_string_view(), text));
+      CHECK(!inside(root->as_object("short")->as_string_view(), text));
+      CHECK(root->as_object("short")->as_string() == "inline");
+    }
+
+  // Copy of the tree owns its strings
+  CHECK(loader.load(text));
+  litejson::json_value copy(*loader.root());
+
+  loader.clear_tree();
+  CHECK(!inside(copy.as_object("this key is long enough")->as_string_view(), text));
+  CHECK(litejson::json_writer::to_string(copy) == copied);
+
+  // Bad text is still found
+  CHECK(!loader.load("[\"long string with bad byte \xff\"]"));
+  CHECK(!loader.load("[\"long string without the end"));
+
+  // Lazy mode refers to its own copy of the text
+  loader.set_zero_copy(false);
+  CHECK(loader.load(text, json_loader::pm_lazy));
+  CHECK(!inside(loader.root()->as_object("list")->as_array(0)->as_string_view(), text));
+  CHECK(litejson::json_writer::to_string(*loader.root()) == copied);
+
+  // Files are kept mapped
+  std::string name = "test18.tmp.json";
+  std::string big = "[";
+
+  for (int i = 0; i < 20000; i++)
+    big += "\"string number " + std::to_string(i) + " is long\", ";
+  big += text + "]";
+  {
+    std::ofstream file(name);
+
+    file << big;
+  }
+
+  json_loader copies;
+  json_loader views;
+
+  copies.enable_stats(true);
+  views.enable_stats(true);
+  views.set_zero_copy(true);
+  CHECK(copies.load_file(name) && views.load_file(name));
+  std::unique_ptr<litejson::json_document> doc = litejson::json_document::from_file(name);
+  std::remove(name.c_str());
+
+  CHECK(!doc->bad());
+  CHECK(litejson::json_writer::to_string(*views.root()) == litejson::json_writer::to_string(*copies.root()));
+  CHECK(litejson::json_writer::to_string(*doc->root()) == litejson::json_writer::to_string(*copies.root()));
+  CHECK(views.root()->as_array(19999)->as_string() == "string number 19999 is long");
+  CHECK(views.stats()->allocated < copies.stats()->allocated);
+
+  // Parallel mode
+  views.set_threads(2);
+  while (big.size() < 2 * json_loader::parallel_min)
+    big.insert(1, "\"one more string which is long\", ");
+  CHECK(views.load(big, json_loader::pm_parallel));
+  CHECK(inside(views.root()->as_array(0)->as_string_view(), big));
+  CHECK(copies.load(big));
+  CHECK(litejson::json_writer::to_string(*views.root()) == litejson::json_writer::to_string(*copies.root()));
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
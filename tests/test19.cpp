@@ -0,0 +1,212 @@
+#include <litejson.h>
+#include <json_key_table.h>
+#include <json_stream.h>
+#include <json_writer.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+using litejson::json_loader;
+using litejson::json_key_table;
+
+static std::string records(size_t count)
+{
+  std::string text = "[";
+
+  for (size_t i = 0; i < count; i++)
+    text += std::string(i != 0 ? ", " : "") + "{\"customer_identifier\": " + std::to_string(i) +
+      ", \"id\": 1, \"shipping_address_line\": \"street " + std::to_string(i) + "\"}";
+  return text + "]";
+}
+
+int main()
+{
+  // Table
+  json_key_table table;
+  bool added;
+  std::string_view first = table.intern("customer_identifier", &added);
+
+  CHECK(added && first == "customer_identifier");
+  CHECK(table.intern(std::string("customer_identifier"), &added).data() == first.data() && !added);
+  CHECK(table.find("customer_identifier").data() == first.data());
+  CHECK(table.find("unknown key").data() == nullptr);
+  CHECK(table.size() == 1 && table.bytes() == 20 && table.hits() == 1 && table.bytes_saved() == 20);
+
+  for (int i = 0; i < 1000; i++)
+    table.intern("key number " + std::to_string(i));
+  CHECK(table.size() == 1001);
+  CHECK(table.find("key number 999") == "key number 999");
+  CHECK(table.find("customer_identifier").data() == first.data());
+  table.clear();
+  CHECK(table.size() == 0 && table.bytes() == 0 && table.find("customer_identifier").data() == nullptr);
+
+  // Threads share the keys
+  std::vector<std::thread> threads;
+  std::vector<std::string_view> found(4 * 1000);
+
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([&, t]
+      {
+        for (int i = 0; i < 1000; i++)
+          found[t * 1000 + i] = table.intern("shared key number " + std::to_string(i));
+      });
+  for (std::thread& thread : threads)
+    thread.join();
+  CHECK(table.size() == 1000 && table.hits() == 3000);
+  for (int i = 0; i < 1000; i++)
+    CHECK(found[i].data() == found[1000 + i].data() && found[i].data() == found[3000 + i].data());
+  table.clear();
+
+  // Limited table stores no more keys, the loader copies them
+  json_key_table small;
+
+  small.set_max_bytes(40);
+  CHECK(small.intern("customer_identifier").data() != nullptr);
+  CHECK(small.intern("shipping_address_line", &added).data() == nullptr && !added);
+  CHECK(small.intern("customer_identifier", &added).data() != nullptr && !added);
+  CHECK(small.size() == 1 && small.bytes() == 20);
+
+  // Loader
+  std::shared_ptr<json_key_table> keys = std::make_shared<json_key_table>();
+  std::string text = records(100);
+  json_loader plain;
+  json_loader loader;
+
+  CHECK(plain.load(text));
+  loader.set_key_table(keys);
+  loader.enable_stats(true);
+  for (json_loader::parse_mode_t mode : { json_loader::pm_single_pass, json_loader::pm_two_pass })
+    {
+      CHECK(loader.load(text, mode));
+      CHECK(litejson::json_writer::to_string(*loader.root()) == litejson::json_writer::to_string(*plain.root()));
+      CHECK(keys->size() == 2);                       // "id" is stored inline
+      CHECK(loader.stats()->keys_interned == 200);
+      CHECK(loader.stats()->key_bytes_saved == (mode == json_loader::pm_single_pass ? 99 * 42 : 100 * 42));
+
+      const litejson::json_value* obj = loader.root()->as_array(42);
+
+      CHECK(obj->as_object("customer_identifier")->as_int64() == 42);
+      CHECK(obj->as_object(keys->find("customer_identifier"))->as_int64() == 42);
+      CHECK(obj->as_object("id")->as_int64() == 1);
+      CHECK(obj->as_object(keys->find("shipping_address_line"))->as_string() == "street 42");
+    }
+
+  // Keys are shared by the loaders, escaped keys are decoded first
+  std::string more = "{\"customer_identifier\": -1, \"customer\\u005fidentifier_2\": 2}";
+  json_loader other;
+  litejson::json_value* doc;
+  size_t hits = keys->hits();
+
+  other.set_key_table(keys);
+  CHECK(other.load(more));
+  CHECK(other.root()->as_object("customer_identifier")->as_int64() == -1);
+  CHECK(other.root()->as_object("customer_identifier_2")->as_int64() == 2);
+  CHECK(keys->find("customer_identifier_2") == "customer_identifier_2");
+  CHECK(keys->size() == 3 && keys->hits() == hits + 1);
+  doc = other.append_document(more);
+  CHECK(doc != nullptr && doc->as_object("customer_identifier_2")->as_int64() == 2);
+  CHECK(keys->size() == 3 && keys->hits() == hits + 3);
+
+  // Copies own their keys
+  litejson::json_value copy(*loader.root());
+
+  loader.clear_tree();
+  other.clear_tree();
+  keys->clear();
+  CHECK(copy.as_array(99)->as_object("customer_identifier")->as_int64() == 99);
+
+  // Large objects with the hash index
+  std::string wide = "{";
+
+  for (int i = 0; i < 100; i++)
+    wide += std::string(i != 0 ? ", " : "") + "\"member with long name " + std::to_string(i) + "\": " + std::to_string(i);
+  wide += "}";
+  CHECK(loader.load(wide));
+  CHECK(loader.root()->as_object("member with long name 77")->as_int64() == 77);
+  CHECK(loader.root()->as_object(keys->find("member with long name 78"))->as_int64() == 78);
+  CHECK(loader.root()->as_object("member with long name 100") == nullptr);
+
+  // Zero copy saves nothing, but keys are still shared
+  loader.set_zero_copy(true);
+  CHECK(loader.load(text));
+  CHECK(loader.stats()->keys_interned == 200 && loader.stats()->key_bytes_saved == 0);
+  loader.set_zero_copy(false);
+
+  // Parallel mode
+  std::string big = records(40000);
+
+  loader.set_threads(2);
+  CHECK(loader.load(big, json_loader::pm_parallel));
+  CHECK(loader.stats()->keys_interned == 80000);
+  CHECK(loader.root()->as_array(39999)->as_object("shipping_address_line")->as_string() == "street 39999");
+
+  // Names of the root object parsed by the workers are taken from the table too
+  std::string object = "{";
+  size_t saved = 0;                                     // All the keys are in the table already
+
+  for (int i = 0; i < 20000; i++)
+    {
+      std::string name = "member with long name " + std::to_string(i % 100);
+
+      object += std::string(i != 0 ? ", " : "") + "\"" + name + "\": " + records(1);
+      saved += name.size() + 1 + 42;
+    }
+  object += "}";
+  for (bool zero_copy : { false, true })
+    {
+      loader.set_zero_copy(zero_copy);
+      CHECK(loader.load(object, json_loader::pm_parallel));
+      CHECK(loader.stats()->keys_interned == 60000);
+      CHECK(loader.stats()->key_bytes_saved == (zero_copy ? 0 : saved));
+      for (const litejson::json_member& member : loader.root()->members())
+        CHECK(member.name.as_string_view().data() == keys->find(member.name.as_string_view()).data());
+    }
+  loader.set_zero_copy(false);
+
+  // Streams
+  std::string lines;
+  json_loader check;
+  litejson::json_stream stream;
+  size_t count = 0;
+
+  for (int i = 0; i < 1000; i++)
+    lines += "{\"customer_identifier\": " + std::to_string(i) + "}\n";
+  stream.set_key_table(keys);
+  stream.set_chunk_size(1000);
+  stream.open(lines);
+  while ((doc = stream.next()) != nullptr)
+    {
+      CHECK(doc->as_object(keys->find("customer_identifier"))->as_int64() == int64_t(count));
+      count++;
+    }
+  CHECK(count == 1000 && !stream.bad());
+
+  count = 0;
+  stream.open(lines);
+  CHECK(stream.for_each([&](litejson::json_value& rec, size_t)
+    {
+      if (rec.as_object(keys->find("customer_identifier")) != nullptr)
+        count++;
+    }, 2));
+  CHECK(count == 1000);
+
+  // Keys over the limit are copied
+  std::shared_ptr<json_key_table> limited = std::make_shared<json_key_table>();
+
+  limited->set_max_bytes(30);
+  check.set_key_table(limited);
+  CHECK(check.load(text));
+  CHECK(litejson::json_writer::to_string(*check.root()) == litejson::json_writer::to_string(*plain.root()));
+  CHECK(limited->size() == 1);
+
+  // Replacing the table deletes the tree
+  CHECK(check.load(text));
+  check.set_key_table(nullptr);
+  CHECK(check.root() == nullptr && check.key_table() == nullptr);
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
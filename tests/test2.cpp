@@ -0,0 +1,157 @@
+#include <json_writer.h>
+#include <litejson.h>
+
+#include <iostream>
+
+#include "check.h"
+
+/**
+ * Does the call throw std::runtime_error
+ */
+template<class F>
+static bool throws(F f)
+{
+  try
+    {
+      f();
+    }
+  catch (std::runtime_error&)
+    {
+      return true;
+    }
+  return false;
+}
+
+int main()
+{
+  litejson::json_value root;
+  litejson::json_value* list = new litejson::json_value();
+
+  CHECK(sizeof(litejson::json_value) == 16);
+
+  for (int i = 0; i < 100; i++)
+    list->add_array_entry(new litejson::json_value((float)i));
+
+  root.add_object_entry("list", list);
+  root.add_object_entry("short", new litejson::json_value("short"));
+  root.add_object_entry("long", new litejson::json_value("this string does not fit inline"));
+  root.add_object_entry("flag", new litejson::json_value(true));
+  root.add_object_entry("flag", new litejson::json_value(false));
+
+  CHECK(root.is_object());
+  CHECK(root.as_object("list")->is_array());
+  CHECK(root.as_object("list")->as_array(99)->as_integer() == 99);
+  CHECK(root.as_object("list")->as_array(100) == nullptr);
+  CHECK(root.as_object("short")->as_string() == "short");
+  CHECK(root.as_object("long")->as_string_view() == "this string does not fit inline");
+  CHECK(root.as_object("flag")->as_boolean() == false);
+  CHECK(root.as_object("missing") == nullptr);
+
+  litejson::json_value copy(root);
+
+  root.make_array();
+  CHECK(root.is_array());
+  CHECK(copy.as_object("list")->as_array(42)->as_float() == 42.0f);
+  CHECK(copy.as_object("long")->as_string() == "this string does not fit inline");
+
+  litejson::json_value moved(std::move(copy));
+
+  CHECK(copy.is_null());
+  CHECK(moved.as_object("short")->as_string() == "short");
+
+  const char numbers[] = "[16777217, 9007199254740993, 18446744073709551615, -9223372036854775808,"
+                         " 0.1, 1.256E-25, -0, 1e400, 123456789012345678901234567890]";
+  litejson::json_loader loader(numbers, sizeof(numbers) - 1);
+
+  CHECK(!loader.bad());
+  CHECK(loader.root()->as_array(0)->as_int64() == 16777217);
+  CHECK(loader.root()->as_array(1)->as_int64() == 9007199254740993LL);
+  CHECK(loader.root()->as_array(2)->as_uint64() == 18446744073709551615ULL);
+  CHECK(loader.root()->as_array(3)->as_int64() == INT64_MIN);
+  CHECK(loader.root()->as_array(4)->as_double() == 0.1);
+  CHECK(loader.root()->as_array(5)->as_double() == 1.256E-25);
+  CHECK(!loader.root()->as_array(6)->is_integer());
+  CHECK(std::signbit(loader.root()->as_array(6)->as_double()));
+  CHECK(loader.root()->as_array(6)->as_int64() == 0);
+  CHECK(litejson::json_writer::to_string(*loader.root()->as_array(6)) == "-0");
+  CHECK(std::isinf(loader.root()->as_array(7)->as_double()));
+  CHECK(loader.root()->as_array(8)->as_double() == 123456789012345678901234567890.0);
+  CHECK(!loader.root()->as_array(8)->is_integer());
+  CHECK(litejson::json_value(-9223372036854775808.0).as_int64() == INT64_MIN);
+  CHECK(litejson::json_value(-0.4).as_uint64() == 0);
+  CHECK(loader.root()->as_array(0)->as_integer() == 16777217);
+  CHECK(throws([&] { loader.root()->as_array(1)->as_integer(); }));
+  CHECK(throws([&] { loader.root()->as_array(3)->as_integer(); }));
+  CHECK(throws([&] { litejson::json_value(-1.0).as_uint64(); }));
+  CHECK(!loader.load("[01]"));
+  CHECK(!loader.load("[1.]"));
+  CHECK(!loader.load("[-]"));
+
+  // Large objects are looked up through the hash index
+  litejson::json_value big;
+  std::string text = "{";
+
+  for (int i = 0; i < 1000; i++)
+    {
+      big.add_object_entry("key" + std::to_string(i), new litejson::json_value(i));
+      text += "\"key" + std::to_string(i) + "\" : " + std::to_string(i) + ", ";
+    }
+  text += "\"key7\" : -7}";
+  big.add_object_entry("key7", new litejson::json_value(-7));
+
+  CHECK(loader.load(text));
+  for (int i = 0; i < 1000; i++)
+    {
+      std::string key = "key" + std::to_string(i);
+      int expected = i == 7 ? -7 : i;
+
+      CHECK(big.as_object(key)->as_integer() == expected);
+      CHECK(loader.root()->as_object(key)->as_integer() == expected);
+      CHECK(loader.root()->as_object(key, litejson::json_value::hash(key))->as_integer() == expected);
+    }
+  CHECK(big.as_object("key1000") == nullptr);
+  CHECK(loader.root()->as_object("") == nullptr);
+
+  // Entry may be moved into its own container
+  litejson::json_value parent;
+
+  parent.add_array_entry(litejson::json_value()).add_array_entry(litejson::json_value("this string does not fit inline"));
+  parent.as_array(0)->add_array_entry(litejson::json_value(2));
+  parent = std::move(*parent.as_array(0));
+  CHECK(parent.as_array(0)->as_string() == "this string does not fit inline");
+  CHECK(parent.as_array(1)->as_integer() == 2);
+
+  // Deep trees are copied and released without recursion
+  litejson::json_value deep;
+  litejson::json_value* node = &deep;
+
+  for (int i = 0; i < 1000000; i++)
+    {
+      node->make_object();
+      node = &node->add_object_entry("k", litejson::json_value());
+    }
+  *node = litejson::json_value("this string does not fit inline");
+
+  litejson::json_value deep_copy(deep);
+
+  deep = litejson::json_value();
+  for (node = &deep_copy; node->is_object(); node = node->as_object("k"))
+    ;
+  CHECK(node->as_string() == "this string does not fit inline");
+
+  litejson::json_value big_copy(*loader.root());
+
+  CHECK(big_copy.as_object(std::string_view("key999"))->as_integer() == 999);
+  CHECK(big_copy.as_object("key7")->as_integer() == -7);
+
+  try
+    {
+      moved.as_float();
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <litejson.h>
+#include <json_key_table.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <numeric>
+
+#include "check.h"
+
+static size_t alloc_count;
+
+void* operator new(size_t size)
+{
+  void* p;
+
+  alloc_count++;
+  if ((p = std::malloc(size != 0 ? size : 1)) == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+using litejson::json_loader;
+using litejson::json_value;
+
+int main()
+{
+  const char text[] = "{\"list\": [1, 2, 3, 4.5, -5], \"name\": \"value\", \"flag\": true, \"big\": 18446744073709551615,"
+                      " \"empty\": [], \"none\": {}, \"name\": \"second\"}";
+  json_loader loader;
+  const json_value* root;
+  const json_value* list;
+  double sum = 0;
+  size_t allocs;
+
+  for (json_loader::parse_mode_t mode : { json_loader::pm_single_pass, json_loader::pm_lazy })
+    {
+      CHECK(loader.load(text, mode));
+      root = loader.root();
+      allocs = alloc_count;
+
+      // Arrays
+      list = root->as_object("list");
+      CHECK(list->size() == 5 && list->items().size() == 5 && !list->items().empty());
+      sum = 0;
+      for (const json_value& item : *list)
+        sum += item.as_double();
+      CHECK(sum == 5.5);
+      CHECK(std::accumulate(list->begin(), list->end(), 0.0, [](double s, const json_value& v) { return s + v.as_double(); }) == 5.5);
+      CHECK(std::find_if(list->begin(), list->end(), [](const json_value& v) { return !v.is_integer(); }) - list->begin() == 3);
+      CHECK(list->items()[4].as_int64() == -5);
+      CHECK(root->as_object("empty")->size() == 0 && root->as_object("empty")->items().empty());
+
+      // Objects, duplicates are listed
+      std::string_view names[7];
+      size_t count = 0;
+
+      CHECK(root->size() == 7 && root->members().size() == 7);
+      for (const litejson::json_member& member : root->members())
+        names[count++] = member.name.as_string_view();
+      CHECK(count == 7 && names[0] == "list" && names[1] == "name" && names[6] == "name");
+      CHECK(root->members()[6].value.as_string_view() == "second");
+      CHECK(root->as_object("none")->members().empty());
+
+      // Other values have no entries
+      CHECK(root->as_object("flag")->size() == 0);
+      CHECK(root->as_object("flag")->items().empty() && root->as_object("flag")->members().empty());
+      CHECK(root->items().empty() && list->members().empty());
+      CHECK(root->begin() == root->end());
+
+      if (mode == json_loader::pm_single_pass)
+        CHECK(alloc_count == allocs);                   // Lazy containers are parsed on access
+    }
+
+  // Typed access
+  bool b = false;
+  int64_t i = 7;
+  uint64_t u = 7;
+  double d = 0;
+  std::string_view s;
+
+  root = loader.root();
+  list = root->as_object("list");
+  allocs = alloc_count;
+  CHECK(root->as_object("flag")->get(b) && b);
+  CHECK(!root->as_object("flag")->get(i) && i == 7);
+  CHECK(list->as_array(0)->get(i) && i == 1);
+  CHECK(list->as_array(0)->get(u) && u == 1);
+  CHECK(!list->as_array(3)->get(i) && i == 1);
+  CHECK(list->as_array(3)->get(d) && d == 4.5);
+  CHECK(list->as_array(4)->get(i) && i == -5);
+  CHECK(!list->as_array(4)->get(u) && u == 1);
+  CHECK(!root->as_object("big")->get(i) && i == -5);
+  CHECK(root->as_object("big")->get(u) && u == UINT64_MAX);
+  CHECK(root->as_object("name")->get(s) && s == "second");
+  CHECK(!root->as_object("name")->get(d) && d == 4.5);
+  CHECK(!list->get(s) && s == "second");
+  CHECK(alloc_count == allocs);
+
+  // Keys of the intern table are shared by the documents
+  std::string key = "a key long enough to be interned";
+  std::string doc = "{\"" + key + "\": 1}";
+
+  loader.set_key_table(std::make_shared<litejson::json_key_table>());
+  CHECK(loader.append_document(doc) != nullptr);
+  const json_value* first = loader.root();
+  CHECK(loader.append_document(doc) != nullptr);
+  CHECK(first != loader.root());
+  CHECK(first->members()[0].name.as_string_view() == key);
+  CHECK(first->members()[0].name.as_string_view().data() == loader.root()->members()[0].name.as_string_view().data());
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <litejson.h>
+#include <json_push_parser.h>
+#include <json_writer.h>
+
+#include <string>
+
+#include "check.h"
+
+using litejson::json_loader;
+using litejson::json_value;
+
+static const std::string long_text(100, 'x');
+
+/**
+ * Put heap storage into the nodes of the loaded tree
+ */
+static bool mutate(json_value& root)
+{
+  json_value* list = root.as_object("list");
+  json_value* name = root.as_object("name");
+
+  for (int i = 0; i < 100; i++)
+    list->add_array_entry(json_value(i));
+  list->as_array(0)->make_object();
+  list->as_array(0)->add_object_entry("inner", json_value(long_text));
+  *name = json_value(long_text);
+  root.add_object_entry("added with a long name", json_value(long_text));
+  root.as_object("nested")->as_object("deep")->add_array_entry(json_value(long_text));
+  root.as_object("nested")->as_object("members")->emplace_object_entry("k", long_text);
+
+  list = root.as_object("list");                        // Members are moved by the new one
+  return list->size() == 103 && root.as_object("name")->as_string_view() == long_text &&
+    root.as_object("added with a long name")->as_string_view() == long_text &&
+    root.as_object("nested")->as_object("deep")->size() == 2;
+}
+
+int main()
+{
+  std::string text = "{\"list\": [1, 2, 3], \"name\": \"short\", \"nested\": {\"deep\": [\"a\"], \"members\": {\"x\": 1}}}";
+  std::string big = "[";
+  json_loader loader;
+
+  for (json_loader::parse_mode_t mode : { json_loader::pm_single_pass, json_loader::pm_two_pass, json_loader::pm_lazy })
+    {
+      CHECK(loader.load(text, mode));
+      CHECK(mutate(*loader.root()));
+      CHECK(loader.load(text, mode));                   // Storage of the changed tree is released
+      CHECK(mutate(*loader.root()));
+    }
+  loader.clear_tree();
+
+  // Documents of the same arena
+  json_value* first = loader.append_document(text);
+
+  CHECK(first != nullptr && mutate(*first));
+  CHECK(loader.append_document(text) != nullptr && mutate(*loader.root()));
+  loader.clear_tree();
+
+  // Entries parsed by the workers
+  while (big.size() < 2 * json_loader::parallel_min)
+    big += text + ", ";
+  big += text + "]";
+  loader.set_threads(2);
+  CHECK(loader.load(big, json_loader::pm_parallel));
+  CHECK(mutate(*loader.root()->as_array(0)) && mutate(*loader.root()->as_array(1000)));
+  loader.root()->add_array_entry(json_value(long_text));
+
+  // Push parser
+  litejson::json_push_parser parser;
+
+  CHECK(parser.feed(text) && parser.finish());
+  CHECK(mutate(*parser.root()));
+  parser.reset();
+  CHECK(parser.feed(text) && parser.finish());
+  CHECK(mutate(*parser.root()));
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
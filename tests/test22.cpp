@@ -0,0 +1,64 @@
+#include <litejson.h>
+#include <json_arena.h>
+
+#include <string>
+
+#include "check.h"
+
+using litejson::json_arena;
+using litejson::json_loader;
+using litejson::json_value;
+
+int main()
+{
+  json_arena arena;
+  char* last = nullptr;
+  char* p;
+
+  // clear() keeps the last block and starts over in it
+  while (arena.block_count() < 3)
+    {
+      p = static_cast<char*>(arena.allocate(1000, 1));
+      if (arena.block_count() == 3)
+        last = p;
+    }
+  CHECK(arena.bytes_reserved() == (64 + 128 + 256) * 1024);
+  arena.clear();
+  CHECK(arena.block_count() == 1 && arena.bytes_reserved() == 256 * 1024);
+  CHECK(arena.allocate(1000, 1) == last);
+  arena.release();
+  CHECK(arena.block_count() == 0 && arena.bytes_reserved() == 0);
+
+  // Reloaded document lives in the kept block
+  std::string text = "{\"list\": [1, 2, 3], \"name\": \"short\", \"flag\": true}";
+  std::string big = "[";
+  json_loader loader;
+  size_t blocks;
+
+  loader.enable_stats(true);
+  for (int i = 0; i < 3; i++)
+    {
+      CHECK(loader.load(text, json_loader::pm_single_pass));
+      CHECK(loader.stats()->allocations == 1 && loader.stats()->allocated == 64 * 1024);
+      CHECK(loader.root()->as_object("list")->size() == 3);
+    }
+
+  while (big.size() < 1024 * 1024)
+    big += text + ", ";
+  big += text + "]";
+  CHECK(loader.load(big, json_loader::pm_single_pass));
+  blocks = loader.stats()->allocations;
+  CHECK(blocks > 1);
+  CHECK(loader.load(big, json_loader::pm_single_pass));
+  CHECK(loader.stats()->allocations < blocks);
+
+  // Tree changed before the clear
+  loader.root()->as_array(0)->as_object("list")->add_array_entry(json_value(std::string(100, 'x')));
+  *loader.root()->as_array(1)->as_object("name") = json_value(std::string(100, 'y'));
+  CHECK(loader.load(text, json_loader::pm_single_pass));
+  CHECK(loader.stats()->allocations == 1);
+  CHECK(loader.root()->as_object("name")->as_string_view() == "short");
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
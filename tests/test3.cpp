@@ -0,0 +1,100 @@
+#include <json_scan.h>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Straightforward bracket index to compare with the vectorized one
+static bool reference_index(const std::string& text, std::vector<uint32_t>& index)
+{
+  bool in_string = false;
+  bool escaped = false;
+
+  index.clear();
+  for (size_t i = 0; i < text.size(); i++)
+    {
+      char c = text[i];
+
+      if (in_string)
+        {
+          if (escaped)
+            escaped = false;
+          else if (c == '\\')
+            escaped = true;
+          else if (c == '"')
+            in_string = false;
+          continue;
+        }
+
+      if (c == '"')
+        in_string = true;
+      else if (c == '{' || c == '}' || c == '[' || c == ']')
+        index.push_back(i);
+    }
+
+  return !in_string;
+}
+
+int main()
+{
+  const char* pieces[] = { "{", "}", "[", "]", ":", ",", " ", "\n", "  \n  ", "a", "01", "-.e" };
+  const char* string_pieces[] = { "a", " ", "\\\\", "\\\"", "\\\\\\\"", "{,}", "\\n" };
+  std::mt19937 rng(1);
+  std::vector<uint32_t> expected;
+  std::vector<uint32_t> index;
+
+  for (int round = 0; round < 2000; round++)
+    {
+      std::string text;
+      size_t size = rng() % 300;
+
+      while (text.size() < size)                        // Backslashes appear only inside strings
+        {
+          if (rng() % 4 != 0)
+            {
+              text += pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))];
+              continue;
+            }
+
+          text += "\"";
+          for (int n = rng() % 40; n != 0; n--)
+            text += string_pieces[rng() % (sizeof(string_pieces) / sizeof(string_pieces[0]))];
+          text += "\"";
+        }
+      if (rng() % 10 == 0)                              // Not terminated string
+        text += "\"abc";
+
+      bool ok = reference_index(text, expected);
+
+      if (litejson::bracket_index(text.data(), text.size(), index) != ok || (ok && index != expected))
+        {
+          std::cout << "Index mismatch for: " << text << std::endl;
+          return -1;
+        }
+
+      const char* end = text.data() + text.size();
+      const char* p = text.data();
+      int lines = 0;
+      int expected_lines = 0;
+
+      while (p != end && (*p == ' ' || *p == '\n'))
+        expected_lines += *p++ == '\n';
+      if (litejson::skip_whitespace(text.data(), end, &lines) != p || lines != expected_lines)
+        {
+          std::cout << "Whitespace mismatch for: " << text << std::endl;
+          return -1;
+        }
+
+      p = text.data();
+      while (p != end && *p != '"' && *p != '\\' && *p != '\n')
+        p++;
+      if (litejson::scan_string(text.data(), end) != p)
+        {
+          std::cout << "String scan mismatch for: " << text << std::endl;
+          return -1;
+        }
+    }
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <litejson.h>
+#include <json_string.h>
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#include "check.h"
+
+static bool decode(const std::string& text, std::string& out)
+{
+  const char* end = text.data() + text.size();
+
+  return litejson::decode_string(text.data(), end, out) == end;
+}
+
+static bool decode_file(const std::string& text, std::string& out)
+{
+  std::string name = "test4.tmp.json";
+  std::ofstream file(name);
+
+  file << "[\"" << text << "]" << std::endl;
+  file.close();
+
+  litejson::json_loader loader(name, litejson::json_loader::pm_two_pass);
+  std::remove(name.c_str());
+
+  if (loader.bad())
+    return false;
+
+  out = loader.root()->as_array(0)->as_string();
+  return true;
+}
+
+int main()
+{
+  std::string out;
+  std::string text;
+
+  // Escapes
+  CHECK(decode("plain\"", out) && out == "plain");
+  CHECK(decode("\\\"\\\\\\/\\b\\f\\n\\r\\t\"", out) && out == "\"\\/\b\f\n\r\t");
+  CHECK(decode("a\\u0041\\u00e9\\u20AC\"", out) && out == "aA\xC3\xA9\xE2\x82\xAC");
+  CHECK(decode("\\ud83d\\ude00\"", out) && out == "\xF0\x9F\x98\x80");
+  CHECK(decode("\\u0000\"", out) && out == std::string(1, '\0'));
+
+  // Long plain parts around escapes
+  text = std::string(100, 'x') + "\\n" + std::string(100, 'y') + "\"";
+  CHECK(decode(text, out) && out == std::string(100, 'x') + "\n" + std::string(100, 'y'));
+
+  // Bad escapes
+  CHECK(!decode("\\x\"", out));
+  CHECK(!decode("\\u12\"", out));
+  CHECK(!decode("\\u12G4\"", out));
+  CHECK(!decode("\\ud83d\"", out));
+  CHECK(!decode("\\ud83d\\u0041\"", out));
+  CHECK(!decode("\\ude00\"", out));
+  CHECK(!decode("tab\there\"", out));
+  CHECK(!decode("unterminated", out));
+  CHECK(!decode("unterminated\\", out));
+
+  // UTF-8
+  CHECK(decode("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\"", out));
+  CHECK(litejson::validate_utf8("\xF4\x8F\xBF\xBF", 4));
+  CHECK(!litejson::validate_utf8("\xC0\xAF", 2));                // Overlong
+  CHECK(!litejson::validate_utf8("\xE0\x80\xAF", 3));            // Overlong
+  CHECK(!litejson::validate_utf8("\xED\xA0\x80", 3));            // Surrogate
+  CHECK(!litejson::validate_utf8("\xF4\x90\x80\x80", 4));        // Above U+10FFFF
+  CHECK(!litejson::validate_utf8("\x80", 1));                    // Stray continuation
+  CHECK(!litejson::validate_utf8("\xE2\x82", 2));                // Truncated
+  text = std::string(40, 'a') + "\xFF" + std::string(40, 'a');
+  CHECK(!litejson::validate_utf8(text.data(), text.size()));
+  CHECK(!decode(text + "\"", out));
+
+  // Both parsers
+  litejson::json_loader loader;
+
+  CHECK(loader.load("{\"k\\u00e9y\" : \"a\\\"b\\\\\"}"));
+  CHECK(loader.root()->as_object("k\xC3\xA9y") != nullptr);
+  CHECK(loader.root()->as_object("k\xC3\xA9y")->as_string() == "a\"b\\");
+  CHECK(!loader.load("[\"\xC3\x28\"]"));
+
+  CHECK(decode_file("line\\nbreak \\\"quoted\\\" \\ud83d\\ude00\"", out));
+  CHECK(out == "line\nbreak \"quoted\" \xF0\x9F\x98\x80");
+  CHECK(!decode_file("\\q\"", out));
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <litejson.h>
+#include <json_pointer.h>
+
+#include <iostream>
+#include <type_traits>
+
+#include "check.h"
+
+int main()
+{
+  // Example of RFC 6901
+  const char rfc[] = "{\"foo\": [\"bar\", \"baz\"], \"\": 0, \"a/b\": 1, \"c%d\": 2, \"e^f\": 3,"
+                     " \"g|h\": 4, \"i\\\\j\": 5, \"k\\\"l\": 6, \" \": 7, \"m~n\": 8}";
+  litejson::json_loader loader(rfc, sizeof(rfc) - 1);
+  const litejson::json_value& root = *loader.root();
+
+  CHECK(!loader.bad());
+
+  // Const tree gives const values, changeable tree gives changeable ones
+  using const_ptr = const litejson::json_value*;
+  using ptr = litejson::json_value*;
+
+  static_assert(std::is_same<decltype(root.at_pointer("")), const_ptr>::value, "at_pointer");
+  static_assert(std::is_same<decltype(root.as_object("foo")), const_ptr>::value, "as_object");
+  static_assert(std::is_same<decltype(root.as_object("foo", 0)), const_ptr>::value, "as_object");
+  static_assert(std::is_same<decltype(root.as_array(0)), const_ptr>::value, "as_array");
+  static_assert(std::is_same<decltype(root.items().begin()), const_ptr>::value, "items");
+  static_assert(std::is_same<decltype(litejson::json_pointer().resolve(root)), const_ptr>::value, "resolve");
+  static_assert(std::is_same<decltype(loader.root()->at_pointer("")), ptr>::value, "at_pointer");
+  static_assert(std::is_same<decltype(loader.root()->as_object("foo")), ptr>::value, "as_object");
+  static_assert(std::is_same<decltype(loader.root()->as_array(0)), ptr>::value, "as_array");
+  static_assert(std::is_same<decltype(litejson::json_pointer().resolve(*loader.root())), ptr>::value, "resolve");
+  CHECK(loader.root()->at_pointer("/foo/1") == root.at_pointer("/foo/1"));
+  CHECK(root.at_pointer("") == &root);
+  CHECK(root.at_pointer("/foo")->is_array());
+  CHECK(root.at_pointer("/foo/0")->as_string() == "bar");
+  CHECK(root.at_pointer("/")->as_integer() == 0);
+  CHECK(root.at_pointer("/a~1b")->as_integer() == 1);
+  CHECK(root.at_pointer("/c%d")->as_integer() == 2);
+  CHECK(root.at_pointer("/e^f")->as_integer() == 3);
+  CHECK(root.at_pointer("/g|h")->as_integer() == 4);
+  CHECK(root.at_pointer("/i\\j")->as_integer() == 5);
+  CHECK(root.at_pointer("/k\"l")->as_integer() == 6);
+  CHECK(root.at_pointer("/ ")->as_integer() == 7);
+  CHECK(root.at_pointer("/m~0n")->as_integer() == 8);
+
+  CHECK(root.at_pointer("/foo/2") == nullptr);
+  CHECK(root.at_pointer("/foo/-") == nullptr);
+  CHECK(root.at_pointer("/foo/01") == nullptr);
+  CHECK(root.at_pointer("/foo/0/x") == nullptr);
+  CHECK(root.at_pointer("/missing/0") == nullptr);
+
+  try
+    {
+      root.at_pointer("foo");
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  try
+    {
+      root.at_pointer("/a~2b");
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  // Compiled pointers
+  litejson::json_pointer pointer;
+
+  CHECK(pointer.size() == 0);
+  CHECK(pointer.resolve(root) == &root);
+  CHECK(!pointer.compile("foo"));
+  CHECK(!pointer.compile("/~"));
+  CHECK(pointer.compile("/m~0n"));
+  CHECK(pointer.size() == 1);
+  CHECK(pointer.resolve(root)->as_integer() == 8);
+
+  litejson::json_pointer rps("/servers/3/limits/rps");
+  litejson::json_pointer name("/servers/3/name");
+
+  CHECK(rps.size() == 4);
+  CHECK(rps.resolve(root) == nullptr);
+
+  for (int n = 0; n < 3; n++)                           // Same pointers, different documents
+    {
+      std::string text = "{\"servers\": [";
+
+      for (int i = 0; i < 4 + n; i++)
+        text += "{\"name\": \"s" + std::to_string(i) + "\", \"limits\": {\"rps\": " + std::to_string(i * 100 + n) + "}},";
+      text += "null]}";
+
+      CHECK(loader.load(text));
+      CHECK(rps.resolve(*loader.root())->as_integer() == 300 + n);
+      CHECK(name.resolve(*loader.root())->as_string() == "s3");
+      CHECK(loader.root()->at_pointer("/servers/3/limits/rps") == rps.resolve(*loader.root()));
+    }
+
+  try
+    {
+      litejson::json_pointer bad("servers");
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
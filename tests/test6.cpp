@@ -0,0 +1,89 @@
+#include <litejson.h>
+#include <json_pointer.h>
+
+#include <iostream>
+
+#include "check.h"
+
+int main()
+{
+  const litejson::json_loader::parse_mode_t lazy = litejson::json_loader::pm_lazy;
+  litejson::json_loader loader;
+
+  // Untouched subtrees are not parsed, so errors inside them are not found
+  CHECK(loader.load("{\"skip\": [1, 2, {\"bad\": tru}], \"keep\": {\"x\": [10, \"s\", null], \"y\": {}}, \"z\": []}", lazy));
+  CHECK(loader.root()->is_object());
+  CHECK(loader.root()->as_object("keep")->as_object("x")->as_array(0)->as_integer() == 10);
+  CHECK(loader.root()->at_pointer("/keep/x/1")->as_string() == "s");
+  CHECK(loader.root()->at_pointer("/keep/x/2")->is_null());
+  CHECK(loader.root()->at_pointer("/keep/y")->is_object());
+  CHECK(loader.root()->at_pointer("/keep/y/a") == nullptr);
+  CHECK(loader.root()->at_pointer("/z/0") == nullptr);
+  CHECK(loader.root()->at_pointer("/skip/1")->as_integer() == 2);
+
+  try
+    {
+      loader.root()->at_pointer("/skip/2/bad");
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  // Copy of the lazy value is complete
+  CHECK(loader.load("[[1, [2, [3, [4]]]], {\"a\": {\"b\": \"long string which is not inline\"}}]", lazy));
+
+  litejson::json_value copy(*loader.root());
+
+  loader.clear_tree();
+  CHECK(copy.at_pointer("/0/1/1/1/0")->as_integer() == 4);
+  CHECK(copy.at_pointer("/1/a/b")->as_string() == "long string which is not inline");
+
+  // Compiled pointer through the lazy containers
+  std::string text = "{\"servers\": [";
+
+  for (int i = 0; i < 100; i++)
+    text += "{\"name\": \"s" + std::to_string(i) + "\", \"limits\": {\"rps\": " + std::to_string(i) + "}},";
+  text += "{}]}";
+
+  litejson::json_pointer rps("/servers/42/limits/rps");
+
+  CHECK(loader.load(text, lazy));
+  CHECK(rps.resolve(*loader.root())->as_integer() == 42);
+
+  // Scalar root
+  CHECK(loader.load("  \"text\"  ", lazy));
+  CHECK(loader.root()->as_string() == "text");
+  CHECK(loader.load("-12.5e1", lazy));
+  CHECK(loader.root()->as_double() == -125.0);
+
+  // Errors found by the structural pass
+  CHECK(!loader.load("", lazy));
+  CHECK(!loader.load("[1, 2", lazy));
+  CHECK(!loader.load("[1, 2}", lazy));
+  CHECK(!loader.load("{\"a\": [}]", lazy));
+  CHECK(!loader.load("[\"unterminated]", lazy));
+  CHECK(!loader.load("[1] [2]", lazy));
+  CHECK(!loader.load("1 2", lazy));
+  CHECK(loader.bad());
+
+  // Errors found on access
+  const char* bad[] = { "[1 2]", "[1,]", "[,1]", "{\"a\" 1}", "{\"a\": 1,}", "{1: 2}", "[\"\\q\"]", "[{} []]" };
+
+  for (const char* b : bad)
+    {
+      CHECK(loader.load(b, lazy));
+      try
+        {
+          loader.root()->is_array() ? loader.root()->as_array(0) : loader.root()->as_object("a");
+          std::cout << "No error in " << b << std::endl;
+          return -1;
+        }
+      catch (std::runtime_error&)
+        {
+        }
+    }
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
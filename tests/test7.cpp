@@ -0,0 +1,114 @@
+#include <litejson.h>
+#include <json_writer.h>
+
+#include <cstdio>
+#include <iostream>
+
+#include "check.h"
+
+using litejson::json_writer;
+
+int main(int argc, char** argv)
+{
+  litejson::json_loader loader;
+
+  // Compact and pretty text
+  CHECK(loader.load("{ \"a\" : [ 1, 2.5, -3, true, false, null, {}, [] ], \"b\" : { \"c\" : \"d\" } }"));
+  CHECK(json_writer::to_string(*loader.root()) == "{\"a\":[1,2.5,-3,true,false,null,{},[]],\"b\":{\"c\":\"d\"}}");
+  CHECK(json_writer::to_string(*loader.root(), 2) ==
+        "{\n"
+        "  \"a\": [\n"
+        "    1,\n"
+        "    2.5,\n"
+        "    -3,\n"
+        "    true,\n"
+        "    false,\n"
+        "    null,\n"
+        "    {},\n"
+        "    []\n"
+        "  ],\n"
+        "  \"b\": {\n"
+        "    \"c\": \"d\"\n"
+        "  }\n"
+        "}");
+
+  // Strings are escaped
+  litejson::json_value str(std::string("q\"b\\s/\b\f\n\r\t\x01\x1F \xC3\xA9"));
+
+  CHECK(json_writer::to_string(str) == "\"q\\\"b\\\\s/\\b\\f\\n\\r\\t\\u0001\\u001f \xC3\xA9\"");
+
+  // Numbers are exact and short
+  CHECK(loader.load("[0.1, 1e21, 1.5e-300, 18446744073709551615, -9223372036854775808, 1e400, 123456789.123456789]"));
+  CHECK(json_writer::to_string(*loader.root()) ==
+        "[0.1,1e+21,1.5e-300,18446744073709551615,-9223372036854775808,null,123456789.12345679]");
+  CHECK(json_writer::to_string(litejson::json_value(0.1f)) == "0.10000000149011612");
+
+  // Written text reads back to the same tree
+  CHECK(loader.load_file(argc > 1 ? argv[1] : "tests/valid.json"));
+
+  std::string compact = json_writer::to_string(*loader.root());
+  std::string pretty = json_writer::to_string(*loader.root(), 4);
+  litejson::json_loader other;
+
+  CHECK(other.load(compact));
+  CHECK(json_writer::to_string(*other.root()) == compact);
+  CHECK(other.load(pretty));
+  CHECK(json_writer::to_string(*other.root()) == compact);
+
+#ifdef __linux__
+  // Pipe has no size, it is read till the end
+  FILE* pipe = popen((std::string("cat ") + (argc > 1 ? argv[1] : "tests/valid.json")).c_str(), "r");
+
+  CHECK(pipe != nullptr);
+  CHECK(other.load_file("/dev/fd/" + std::to_string(fileno(pipe))));
+  CHECK(json_writer::to_string(*other.root()) == compact);
+  pclose(pipe);
+#endif
+
+  // Lazy document is written completely
+  CHECK(other.load(pretty, litejson::json_loader::pm_lazy));
+  CHECK(json_writer::to_string(*other.root()) == compact);
+
+  // Sink gets the text by parts
+  std::string big = "[";
+  std::string received;
+  size_t calls = 0;
+
+  for (int i = 0; i < 100000; i++)
+    big += "\"item " + std::to_string(i) + "\",";
+  big += "null]";
+  CHECK(loader.load(big));
+
+  {
+    json_writer writer([&](std::string_view text) { received += text; calls++; });
+
+    writer.write(*loader.root());
+    CHECK(calls > 1);
+    writer.flush();
+  }
+
+  CHECK(received == big);
+
+  // Streaming output goes to the sink by parts too, the rest only by flush()
+  received.clear();
+  calls = 0;
+
+  {
+    json_writer writer([&](std::string_view text) { received += text; calls++; });
+
+    writer.begin_array();
+    for (int i = 0; i < 100000; i++)
+      writer.value("item " + std::to_string(i));
+    writer.null_value();
+    writer.end_array();
+    CHECK(calls > 1 && received.size() < big.size());
+    writer.flush();
+    CHECK(received == big);
+    writer.begin_array();
+  }
+
+  CHECK(received == big);
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
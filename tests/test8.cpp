@@ -0,0 +1,143 @@
+#include <litejson.h>
+#include <json_push_parser.h>
+#include <json_writer.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <cstring>
+
+#include "check.h"
+
+using litejson::json_writer;
+
+/**
+ * Feed the text by chunks of random size and write the tree
+ */
+static std::string push(const std::string& text, std::mt19937& rng, size_t max_chunk)
+{
+  litejson::json_push_parser parser;
+  size_t offset = 0;
+
+  while (offset < text.size())
+    {
+      size_t n = std::min<size_t>(rng() % max_chunk + 1, text.size() - offset);
+
+      if (!parser.feed(text.data() + offset, n))
+        return "error";
+      offset += n;
+    }
+
+  if (!parser.finish())
+    return "error";
+  return json_writer::to_string(*parser.root());
+}
+
+int main(int argc, char** argv)
+{
+  std::mt19937 rng(12345);
+  litejson::json_loader loader;
+
+  if (argc > 2 && std::strcmp(argv[1], "-") == 0)       // Read stdin as it comes through the pipe
+    {
+      litejson::json_push_parser parser;
+      char buf[4096];
+
+      while (std::cin)
+        {
+          std::cin.read(buf, rng() % sizeof(buf) + 1);
+          CHECK(parser.feed(buf, std::cin.gcount()));
+        }
+
+      CHECK(parser.finish());
+      CHECK(loader.load_file(argv[2]));
+      CHECK(json_writer::to_string(*parser.root()) == json_writer::to_string(*loader.root()));
+      std::cout << "All checks passed" << std::endl;
+      return 0;
+    }
+
+  // Tokens are split at every position
+  std::string text = "{\"k\\u00e9y\" : [\"a\\\"b\\\\c\\ud83d\\ude00\", -12.5e+3, 18446744073709551615, true, false, null, {}, []],"
+                     " \"n\" : 0, \"s\" : \"long string which does not fit inline\"}";
+
+  CHECK(loader.load(text));
+
+  std::string expected = json_writer::to_string(*loader.root());
+
+  for (size_t split = 0; split <= text.size(); split++)
+    {
+      litejson::json_push_parser parser;
+
+      CHECK(parser.feed(text.data(), split));
+      CHECK(parser.feed(text.data() + split, text.size() - split));
+      CHECK(parser.finish());
+      CHECK(json_writer::to_string(*parser.root()) == expected);
+    }
+
+  for (size_t max_chunk : { 1, 2, 3, 7, 64 })
+    CHECK(push(text, rng, max_chunk) == expected);
+
+  // Scalar documents end with finish()
+  CHECK(push("  123", rng, 2) == "123");
+  CHECK(push("true ", rng, 1) == "true");
+  CHECK(push("\"abc\"", rng, 1) == "\"abc\"");
+
+  // Bad documents
+  const char* bad[] = { "", "[", "[1,]", "[,1]", "{\"a\" 1}", "{\"a\":1,}", "{1:2}", "[\"\\q\"]", "[1 2]",
+                        "[nul]", "[truex]", "[01]", "[\"a\nb\"]", "[1] 2", "\"abc", "[1}", "{\"a\":1]" };
+
+  for (const char* b : bad)
+    for (size_t max_chunk : { 1, 100 })
+      if (push(b, rng, max_chunk) != "error")
+        {
+          std::cout << "No error in " << b << std::endl;
+          return -1;
+        }
+
+  // Whole file by chunks of random size
+  if (argc > 1)
+    {
+      std::ifstream ifs(argv[1], std::ios::binary);
+      std::stringstream ss;
+
+      ss << ifs.rdbuf();
+      CHECK(loader.load(ss.str()));
+      expected = json_writer::to_string(*loader.root());
+
+      for (size_t max_chunk : { 1, 5, 64, 4096, 65536 })
+        CHECK(push(ss.str(), rng, max_chunk) == expected);
+    }
+
+  // Parser is reusable
+  litejson::json_push_parser parser;
+
+  CHECK(!parser.feed("[1,,2]"));
+  CHECK(parser.bad());
+  parser.reset();
+  CHECK(parser.feed("[1,") && parser.feed("2]") && parser.finish());
+  CHECK(parser.root()->as_array(1)->as_integer() == 2);
+  CHECK(!parser.feed("3"));
+
+  // Nesting is limited, errors go to the log
+  std::ostringstream log;
+
+  parser.reset();
+  parser.set_log(&log);
+  CHECK(parser.feed(std::string(litejson::json_push_parser::default_max_depth, '[')) && log.str().empty());
+  CHECK(!parser.feed("[") && log.str().find("Nesting is too deep") != std::string::npos);
+  parser.reset();
+  parser.set_max_depth(2);
+  CHECK(parser.feed("[[1], {\"a\": 2}]") && parser.finish());
+  parser.reset();
+  CHECK(!parser.feed("[{\"a\": []}]"));
+  parser.reset();
+  parser.set_max_depth(litejson::json_push_parser::default_max_depth);
+  CHECK(!parser.feed(std::string(200000, '[')));
+  parser.reset();
+  parser.set_log(nullptr);
+  CHECK(!parser.feed("[1 2]") && parser.bad());
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <json_stream.h>
+#include <json_thread_pool.h>
+#include <json_writer.h>
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+#include "check.h"
+
+typedef std::vector<std::pair<size_t, std::string>> records_t;
+
+int main()
+{
+  // Thread pool runs every task once
+  litejson::json_thread_pool pool(4);
+  std::vector<std::atomic<int>> runs(1000);
+
+  CHECK(pool.size() == 4);
+  for (int r = 0; r < 3; r++)
+    pool.run(runs.size(), [&](size_t task, unsigned) { runs[task]++; });
+  for (auto& n : runs)
+    CHECK(n == 3);
+
+  try
+    {
+      pool.run(10, [&](size_t task, unsigned) { if (task == 7) throw std::runtime_error("task"); });
+      return -1;
+    }
+  catch (std::runtime_error&)
+    {
+    }
+
+  // JSON Lines text with blank lines and CRLF
+  std::string text;
+
+  for (int i = 0; i < 5000; i++)
+    {
+      text += "{\"id\": " + std::to_string(i) + ", \"name\": \"record " + std::to_string(i) + "\", \"tags\": [1, 2, 3]}";
+      text += i % 7 == 0 ? "\r\n\n" : "\n";
+    }
+  text += "[\"last line without new line\"]";
+
+  litejson::json_stream stream;
+  records_t sequential;
+  size_t offset;
+
+  stream.set_chunk_size(4096);
+  stream.open(text);
+  while (litejson::json_value* doc = stream.next(&offset))
+    sequential.emplace_back(offset, litejson::json_writer::to_string(*doc));
+
+  CHECK(!stream.bad());
+  CHECK(sequential.size() == 5001);
+  CHECK(sequential[0].first == 0);
+  CHECK(sequential[42].second == "{\"id\":42,\"name\":\"record 42\",\"tags\":[1,2,3]}");
+  CHECK(text.compare(sequential[4999].first, 12, "{\"id\": 4999,") == 0);
+  CHECK(sequential[5000].second == "[\"last line without new line\"]");
+
+  for (unsigned threads : { 1, 2, 4 })
+    {
+      records_t ordered;
+      records_t unordered;
+      std::mutex lock;
+
+      CHECK(stream.for_each([&](litejson::json_value& doc, size_t offset)
+        {
+          ordered.emplace_back(offset, litejson::json_writer::to_string(doc));
+        }, threads, litejson::json_stream::o_ordered));
+      CHECK(ordered == sequential);
+
+      CHECK(stream.for_each([&](litejson::json_value& doc, size_t offset)
+        {
+          std::lock_guard<std::mutex> guard(lock);
+
+          unordered.emplace_back(offset, litejson::json_writer::to_string(doc));
+        }, threads, litejson::json_stream::o_unordered));
+      std::sort(unordered.begin(), unordered.end());
+      CHECK(unordered == sequential);
+    }
+
+  // Bad record stops the stream, records before it are passed
+  std::string bad = text.substr(0, sequential[3000].first) + "{\"id\": 3000,,}\n" + text.substr(sequential[3001].first);
+  size_t count = 0;
+
+  stream.open(bad);
+  while (stream.next() != nullptr)
+    count++;
+  CHECK(stream.bad());
+  CHECK(stream.bad_offset() == sequential[3000].first);
+  CHECK(count == 3000);
+
+  count = 0;
+  stream.open(bad);
+  CHECK(!stream.for_each([&](litejson::json_value&, size_t) { count++; }, 4));
+  CHECK(stream.bad());
+  CHECK(stream.bad_offset() == sequential[3000].first);
+  CHECK(count == 3000);
+
+  // Exception of the handler stops the pass, the stream is usable after it
+  for (litejson::json_stream::order_t order : { litejson::json_stream::o_ordered, litejson::json_stream::o_unordered })
+    {
+      std::atomic<size_t> passed(0);
+      bool thrown = false;
+
+      stream.open(text);
+      try
+        {
+          stream.for_each([&](litejson::json_value& doc, size_t)
+            {
+              if (doc.is_object() && doc.as_object("id")->as_integer() == 1000)
+                throw std::runtime_error("handler");
+            }, 4, order);
+        }
+      catch (const std::runtime_error&)
+        {
+          thrown = true;
+        }
+      CHECK(thrown);
+
+      CHECK(stream.for_each([&](litejson::json_value&, size_t) { passed++; }, 4, order));
+      CHECK(passed == 5001);
+    }
+
+  // Chunks parsed before the exception are not passed again by the next ordered pass
+  {
+    records_t ordered;
+
+    try
+      {
+        stream.for_each([&](litejson::json_value& doc, size_t)
+          {
+            if (doc.is_object() && doc.as_object("id")->as_integer() == 20)
+              throw std::runtime_error("handler");
+          }, 4, litejson::json_stream::o_ordered);
+      }
+    catch (const std::runtime_error&)
+      {
+      }
+    CHECK(stream.for_each([&](litejson::json_value& doc, size_t offset)
+      {
+        ordered.emplace_back(offset, litejson::json_writer::to_string(doc));
+      }, 4, litejson::json_stream::o_ordered));
+    CHECK(ordered == sequential);
+  }
+
+  // Empty stream
+  stream.open(std::string_view("\n\n  \n"));
+  CHECK(stream.next() == nullptr);
+  CHECK(!stream.bad());
+  CHECK(stream.for_each([&](litejson::json_value&, size_t) { }));
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}